@@ -0,0 +1,421 @@
+// Fuzz round-trip for the activity serializer: random presence text (control
+// characters, quotes, multi-byte and invalid UTF-8) is serialized, parsed back
+// with a strict JSON parser and compared. Also checks that steady-state
+// serialization performs zero heap allocations.
+//
+//   json_fuzz [--iterations N] [--seed S]
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "activity_serializer.h"
+#include "json_writer.h"
+
+// Global allocation counter; only read around the serializer calls
+static std::atomic<size_t> g_allocations{0};
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+    // Minimal strict JSON parser (RFC 8259): rejects raw control characters,
+    // bad escapes, lone surrogates and invalid UTF-8 inside strings
+    struct JsonValue {
+        enum class Type { Null, Bool, Number, String, Array, Object } type = Type::Null;
+        std::string text;
+        std::vector<JsonValue> items;
+        std::map<std::string, JsonValue> members;
+
+        const JsonValue* Find(const std::string& key) const {
+            auto it = members.find(key);
+            return it == members.end() ? nullptr : &it->second;
+        }
+    };
+
+    size_t Utf8SequenceLength(const std::string& s, size_t i) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        size_t length;
+        uint32_t min;
+        uint32_t cp;
+        if (c < 0x80) return 1;
+        if ((c & 0xE0) == 0xC0) { length = 2; min = 0x80; cp = c & 0x1F; }
+        else if ((c & 0xF0) == 0xE0) { length = 3; min = 0x800; cp = c & 0x0F; }
+        else if ((c & 0xF8) == 0xF0) { length = 4; min = 0x10000; cp = c & 0x07; }
+        else return 0;
+        if (i + length > s.size()) return 0;
+        for (size_t k = 1; k < length; ++k) {
+            unsigned char next = static_cast<unsigned char>(s[i + k]);
+            if ((next & 0xC0) != 0x80) return 0;
+            cp = (cp << 6) | (next & 0x3F);
+        }
+        if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return 0;
+        return length;
+    }
+
+    bool IsValidUtf8(const std::string& s) {
+        for (size_t i = 0; i < s.size();) {
+            size_t length = Utf8SequenceLength(s, i);
+            if (length == 0) return false;
+            i += length;
+        }
+        return true;
+    }
+
+    void AppendUtf8(std::string& out, uint32_t cp) {
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+
+    class StrictParser {
+    public:
+        explicit StrictParser(const std::string& input) : s(input) {}
+
+        bool Parse(JsonValue& out, std::string& error) {
+            bool ok = ParseValue(out, 0) && (SkipWhitespace(), pos == s.size());
+            if (!ok) {
+                error = "invalid JSON near byte " + std::to_string(pos);
+            }
+            return ok;
+        }
+
+    private:
+        void SkipWhitespace() {
+            while (pos < s.size() && (s[pos] == ' ' || s[pos] == '\t' || s[pos] == '\n' || s[pos] == '\r')) ++pos;
+        }
+
+        bool Consume(char c) {
+            SkipWhitespace();
+            if (pos < s.size() && s[pos] == c) { ++pos; return true; }
+            return false;
+        }
+
+        bool ParseValue(JsonValue& out, int depth) {
+            if (depth > 64) return false;
+            SkipWhitespace();
+            if (pos >= s.size()) return false;
+            char c = s[pos];
+            if (c == '{') return ParseObject(out, depth);
+            if (c == '[') return ParseArray(out, depth);
+            if (c == '"') { out.type = JsonValue::Type::String; return ParseString(out.text); }
+            if (s.compare(pos, 4, "true") == 0) { pos += 4; out.type = JsonValue::Type::Bool; out.text = "true"; return true; }
+            if (s.compare(pos, 5, "false") == 0) { pos += 5; out.type = JsonValue::Type::Bool; out.text = "false"; return true; }
+            if (s.compare(pos, 4, "null") == 0) { pos += 4; out.type = JsonValue::Type::Null; return true; }
+            return ParseNumber(out);
+        }
+
+        bool ParseObject(JsonValue& out, int depth) {
+            out.type = JsonValue::Type::Object;
+            ++pos;
+            if (Consume('}')) return true;
+            do {
+                SkipWhitespace();
+                std::string key;
+                if (pos >= s.size() || s[pos] != '"' || !ParseString(key)) return false;
+                if (!Consume(':')) return false;
+                JsonValue value;
+                if (!ParseValue(value, depth + 1)) return false;
+                if (!out.members.emplace(key, std::move(value)).second) return false; // duplicate key
+            } while (Consume(','));
+            return Consume('}');
+        }
+
+        bool ParseArray(JsonValue& out, int depth) {
+            out.type = JsonValue::Type::Array;
+            ++pos;
+            if (Consume(']')) return true;
+            do {
+                JsonValue value;
+                if (!ParseValue(value, depth + 1)) return false;
+                out.items.push_back(std::move(value));
+            } while (Consume(','));
+            return Consume(']');
+        }
+
+        bool ParseNumber(JsonValue& out) {
+            size_t start = pos;
+            if (pos < s.size() && s[pos] == '-') ++pos;
+            if (pos >= s.size() || !isdigit(static_cast<unsigned char>(s[pos]))) return false;
+            if (s[pos] == '0') {
+                ++pos;
+            } else {
+                while (pos < s.size() && isdigit(static_cast<unsigned char>(s[pos]))) ++pos;
+            }
+            out.type = JsonValue::Type::Number;
+            out.text = s.substr(start, pos - start);
+            return true;
+        }
+
+        bool ParseHex4(uint32_t& value) {
+            if (pos + 4 > s.size()) return false;
+            value = 0;
+            for (int i = 0; i < 4; ++i) {
+                char c = s[pos++];
+                value <<= 4;
+                if (c >= '0' && c <= '9') value |= c - '0';
+                else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+                else return false;
+            }
+            return true;
+        }
+
+        bool ParseString(std::string& out) {
+            ++pos;
+            while (pos < s.size()) {
+                unsigned char c = static_cast<unsigned char>(s[pos]);
+                if (c == '"') { ++pos; return true; }
+                if (c < 0x20) return false;
+                if (c == '\\') {
+                    if (++pos >= s.size()) return false;
+                    char e = s[pos++];
+                    switch (e) {
+                        case '"': out += '"'; break;
+                        case '\\': out += '\\'; break;
+                        case '/': out += '/'; break;
+                        case 'b': out += '\b'; break;
+                        case 'f': out += '\f'; break;
+                        case 'n': out += '\n'; break;
+                        case 'r': out += '\r'; break;
+                        case 't': out += '\t'; break;
+                        case 'u': {
+                            uint32_t cp;
+                            if (!ParseHex4(cp)) return false;
+                            if (cp >= 0xDC00 && cp <= 0xDFFF) return false;
+                            if (cp >= 0xD800 && cp <= 0xDBFF) {
+                                uint32_t low;
+                                if (s.compare(pos, 2, "\\u") != 0) return false;
+                                pos += 2;
+                                if (!ParseHex4(low) || low < 0xDC00 || low > 0xDFFF) return false;
+                                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                            }
+                            AppendUtf8(out, cp);
+                            break;
+                        }
+                        default:
+                            return false;
+                    }
+                    continue;
+                }
+                size_t length = Utf8SequenceLength(s, pos);
+                if (length == 0) return false;
+                out.append(s, pos, length);
+                pos += length;
+            }
+            return false;
+        }
+
+        const std::string& s;
+        size_t pos = 0;
+    };
+
+    // Mix of everything that has to be escaped or replaced
+    std::string RandomText(std::mt19937& rng, size_t maxLength) {
+        static const char* const pieces[] = {
+            "\"", "\\", "/", "\n", "\r", "\t", "\b", "\f", "\x01", "\x1f", "\x7f",
+            "é", "ß", "€", "日本", "🎹", "\xE2\x80\xA8", "\xE2\x80\xA9",
+            "\xC0\xAF", "\xED\xA0\x80", "\xF4\x90\x80\x80", "\xE2\x82", "\x80", "\xFF",
+            "Project", " ", "-", "_", ".flp"
+        };
+        constexpr size_t pieceCount = sizeof(pieces) / sizeof(pieces[0]);
+
+        std::uniform_int_distribution<size_t> lengthDist(0, maxLength);
+        std::uniform_int_distribution<int> kindDist(0, 3);
+        std::uniform_int_distribution<size_t> pieceDist(0, pieceCount - 1);
+        std::uniform_int_distribution<int> byteDist(0, 255);
+        std::uniform_int_distribution<int> asciiDist(0x20, 0x7E);
+
+        std::string text;
+        size_t target = lengthDist(rng);
+        while (text.size() < target) {
+            switch (kindDist(rng)) {
+                case 0: text += pieces[pieceDist(rng)]; break;
+                case 1: text += static_cast<char>(byteDist(rng)); break;
+                default: text += static_cast<char>(asciiDist(rng)); break;
+            }
+        }
+        return text;
+    }
+
+    struct Failure {
+        size_t iteration;
+        std::string what;
+    };
+
+    bool CheckString(const JsonValue* value, const std::string& input, const char* name, std::string& what) {
+        if (!value || value->type != JsonValue::Type::String) {
+            what = std::string(name) + " missing";
+            return false;
+        }
+        if (!IsValidUtf8(value->text)) {
+            what = std::string(name) + " decoded to invalid UTF-8";
+            return false;
+        }
+        // Valid input must round-trip exactly; invalid input only has to
+        // come back as valid UTF-8 (bad bytes become U+FFFD)
+        if (IsValidUtf8(input) && value->text != input) {
+            what = std::string(name) + " did not round-trip";
+            return false;
+        }
+        return true;
+    }
+
+    bool CheckActivity(const std::string& json, const RenderedPresence& presence, std::string& what) {
+        JsonValue root;
+        StrictParser parser(json);
+        if (!parser.Parse(root, what)) return false;
+
+        const JsonValue* args = root.Find("args");
+        const JsonValue* activity = args ? args->Find("activity") : nullptr;
+        if (!activity) {
+            what = "activity missing";
+            return false;
+        }
+        const JsonValue* assets = activity->Find("assets");
+        if (!CheckString(activity->Find("details"), presence.details.ToString(), "details", what) ||
+            !CheckString(activity->Find("state"), presence.state.ToString(), "state", what) ||
+            !CheckString(assets ? assets->Find("large_text") : nullptr, presence.largeText.ToString(), "large_text", what)) {
+            return false;
+        }
+
+        const JsonValue* buttons = activity->Find("buttons");
+        size_t buttonCount = buttons ? buttons->items.size() : 0;
+        if (buttonCount != presence.buttonCount) {
+            what = "button count mismatch";
+            return false;
+        }
+        for (size_t i = 0; i < buttonCount; ++i) {
+            const JsonValue& button = buttons->items[i];
+            if (!CheckString(button.Find("label"), presence.buttons[i].label.ToString(), "button label", what) ||
+                !CheckString(button.Find("url"), presence.buttons[i].url.ToString(), "button url", what)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void FillPresence(std::mt19937& rng, RenderedPresence& presence) {
+        presence.active = true;
+        presence.details.Assign(RandomText(rng, 160));
+        presence.state.Assign(RandomText(rng, 160));
+        presence.largeText.Assign(RandomText(rng, 64));
+        presence.startTimestamp = static_cast<std::time_t>(rng() % 2000000000u);
+        presence.buttonCount = rng() % (DISCORD_MAX_BUTTONS + 1);
+        for (size_t i = 0; i < presence.buttonCount; ++i) {
+            presence.buttons[i].label.Assign(RandomText(rng, 40));
+            presence.buttons[i].url.Assign(RandomText(rng, 600));
+        }
+    }
+
+    // Largest possible payload: every byte of every field needs a \u00XX escape
+    void FillWorstCase(RenderedPresence& presence) {
+        presence.active = true;
+        std::string control(DISCORD_BUTTON_URL_MAX_BYTES, '\x01');
+        presence.details.Assign(control);
+        presence.state.Assign(control);
+        presence.largeText.Assign(control);
+        presence.startTimestamp = 2000000000;
+        presence.buttonCount = DISCORD_MAX_BUTTONS;
+        for (size_t i = 0; i < DISCORD_MAX_BUTTONS; ++i) {
+            presence.buttons[i].label.Assign(control);
+            presence.buttons[i].url.Assign(control);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t iterations = 100000;
+    unsigned seed = std::random_device{}();
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            std::cerr << "Usage: json_fuzz [--iterations N] [--seed S]" << std::endl;
+            return 2;
+        }
+    }
+
+    std::cout << "Fuzzing activity serializer: " << iterations << " iterations, seed " << seed << std::endl;
+
+    std::mt19937 rng(seed);
+    JsonWriter writer;
+    auto presence = std::make_unique<RenderedPresence>();
+
+    // Warm up: grow the writer to the largest payload it can ever produce
+    FillWorstCase(*presence);
+    WriteSetActivity(writer, 4242, *presence, 1);
+    WriteHandshake(writer, "123456789012345678");
+
+    std::vector<Failure> failures;
+    size_t steadyStateAllocations = 0;
+    size_t payloadBytes = 0;
+
+    for (size_t i = 0; i < iterations; ++i) {
+        FillPresence(rng, *presence);
+
+        size_t before = g_allocations.load(std::memory_order_relaxed);
+        WriteSetActivity(writer, 4242, *presence, i + 2);
+        steadyStateAllocations += g_allocations.load(std::memory_order_relaxed) - before;
+
+        std::string json(writer.View());
+        payloadBytes += json.size();
+
+        std::string what;
+        if (!CheckActivity(json, *presence, what)) {
+            if (failures.size() < 10) {
+                failures.push_back({i, what + ": " + json});
+            }
+        }
+    }
+
+    std::cout << "Average payload: " << (iterations ? payloadBytes / iterations : 0) << " bytes, "
+              << "writer capacity " << writer.Capacity() << " bytes" << std::endl;
+    std::cout << "Heap allocations during serialization after warm-up: " << steadyStateAllocations << std::endl;
+
+    for (const auto& failure : failures) {
+        std::cerr << "Iteration " << failure.iteration << ": " << failure.what << std::endl;
+    }
+
+    if (!failures.empty() || steadyStateAllocations != 0) {
+        std::cerr << "FAILED" << std::endl;
+        return 1;
+    }
+    std::cout << "OK" << std::endl;
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,224 @@
+// End-to-end latency: simulated FL Studio state change -> SET_ACTIVITY frame
+// at a mock Discord endpoint, through the real FLStudioDiscordApp pipeline.
+//
+//   latency_bench [--runs N] [--intervals 100,250,500]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "discord_client.h"
+#include "fl_studio_detector.h"
+#include "logger.h"
+#include "mock_discord_server.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int FAKE_FL_PID = 4242;
+
+    // Fake process table + window titles the detector reads through its sources
+    class FakeSystem {
+    public:
+        void SetFLRunning(bool running, const std::string& title) {
+            std::lock_guard<std::mutex> lock(mutex);
+            flRunning = running;
+            flTitle = title;
+        }
+
+        std::vector<ProcessInfo> GetProcesses() {
+            std::vector<ProcessInfo> processes;
+            for (int pid = 100; pid < 400; ++pid) {
+                ProcessInfo info;
+                info.pid = pid;
+                info.name = "process" + std::to_string(pid);
+                info.executablePath = "/usr/bin/" + info.name;
+                processes.push_back(info);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (flRunning) {
+                ProcessInfo fl;
+                fl.pid = FAKE_FL_PID;
+                fl.name = "FL64.exe";
+                fl.executablePath = "C:\\Program Files\\Image-Line\\FL Studio 21\\FL64.exe";
+                processes.push_back(fl);
+            }
+            return processes;
+        }
+
+        std::string GetWindowTitle(int pid) {
+            std::lock_guard<std::mutex> lock(mutex);
+            return (pid == FAKE_FL_PID && flRunning) ? flTitle : std::string();
+        }
+
+    private:
+        std::mutex mutex;
+        bool flRunning = false;
+        std::string flTitle;
+    };
+
+    struct Samples {
+        std::vector<double> milliseconds;
+        int timeouts = 0;
+    };
+
+    double Percentile(std::vector<double> values, double percentile) {
+        if (values.empty()) return 0.0;
+        std::sort(values.begin(), values.end());
+        size_t index = static_cast<size_t>(percentile * (values.size() - 1) + 0.5);
+        return values[std::min(index, values.size() - 1)];
+    }
+
+    std::vector<int> ParseIntervals(const std::string& list) {
+        std::vector<int> intervals;
+        std::stringstream stream(list);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            if (!item.empty()) intervals.push_back(std::atoi(item.c_str()));
+        }
+        return intervals;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int runs = 20;
+    std::vector<int> intervals = {100, 250, 500, 1000};
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            runs = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--intervals") == 0 && i + 1 < argc) {
+            intervals = ParseIntervals(argv[++i]);
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--runs N] [--intervals 100,250,500]" << std::endl;
+            return 2;
+        }
+    }
+
+    // Private runtime dir so the app finds our mock instead of a real Discord
+    char dirTemplate[] = "/tmp/flrpc-bench-XXXXXX";
+    const char* runtimeDir = mkdtemp(dirTemplate);
+    if (!runtimeDir) {
+        std::perror("mkdtemp");
+        return 1;
+    }
+    setenv("XDG_RUNTIME_DIR", runtimeDir, 1);
+
+    MockDiscordServer server(std::string(runtimeDir) + "/discord-ipc-0");
+    if (!server.Start()) {
+        std::cerr << "Failed to start mock Discord server" << std::endl;
+        return 1;
+    }
+
+    // The app logs every presence update; keep the report readable
+    Logger::Options logging;
+    logging.console = false;
+    Logger::Instance().Configure(logging);
+
+    std::mt19937 rng(12345);
+    std::map<int, std::map<std::string, Samples>> results;
+    int connections = 0;
+
+    for (int intervalMs : intervals) {
+        auto interval = std::chrono::milliseconds(intervalMs);
+        auto timeout = interval * 4 + std::chrono::milliseconds(2000);
+
+        FakeSystem system;
+        FLStudioDiscordApp app("1395851731312836760");
+        app.GetDetector().SetProcessSource([&system] { return system.GetProcesses(); });
+        app.GetDetector().SetWindowTitleSource([&system](int pid) { return system.GetWindowTitle(pid); });
+        app.SetUpdateInterval(interval);
+
+        if (!app.Initialize()) {
+            std::cerr << "Failed to initialize app" << std::endl;
+            return 1;
+        }
+        std::thread runner([&app] { app.Run(); });
+
+        if (!server.WaitForConnections(++connections, std::chrono::seconds(10))) {
+            std::cerr << "App never connected to the mock endpoint" << std::endl;
+            app.Stop();
+            runner.join();
+            return 1;
+        }
+
+        auto& byEvent = results[intervalMs];
+        std::uniform_int_distribution<int> phase(0, intervalMs);
+
+        for (int run = 0; run < runs; ++run) {
+            std::string project = "Run" + std::to_string(intervalMs) + "_" + std::to_string(run);
+            std::string title = "FL Studio 21 - " + project + ".flp";
+
+            struct Step {
+                const char* name;
+                bool running;
+                std::string title;
+                std::string expect;
+            };
+            const Step steps[] = {
+                {"appear", true, title, "Working on " + project},
+                {"unsaved", true, title + " *", "Unsaved"},
+                {"exit", false, "", "\"details\":\"FL Studio\""}
+            };
+
+            for (const auto& step : steps) {
+                // Land the change at a random point of the update cycle
+                std::this_thread::sleep_for(std::chrono::milliseconds(phase(rng)));
+                server.DiscardPending();
+
+                auto changed = Clock::now();
+                system.SetFLRunning(step.running, step.title);
+
+                MockDiscordServer::Frame frame;
+                bool received = server.WaitForActivity(
+                    [&](const std::string& payload) { return payload.find(step.expect) != std::string::npos; },
+                    std::chrono::duration_cast<std::chrono::milliseconds>(timeout), frame);
+
+                Samples& samples = byEvent[step.name];
+                if (received) {
+                    samples.milliseconds.push_back(
+                        std::chrono::duration<double, std::milli>(frame.received - changed).count());
+                } else {
+                    ++samples.timeouts;
+                }
+            }
+        }
+
+        app.Stop();
+        runner.join();
+    }
+
+    server.Stop();
+    rmdir(runtimeDir);
+    Logger::Instance().Shutdown();
+
+    std::printf("%-10s %-8s %6s %10s %10s %10s %9s\n", "interval", "event", "n", "p50 ms", "p99 ms", "max ms", "timeouts");
+    bool anyTimeouts = false;
+    for (const auto& intervalEntry : results) {
+        for (const char* event : {"appear", "unsaved", "exit"}) {
+            auto found = intervalEntry.second.find(event);
+            if (found == intervalEntry.second.end()) continue;
+            const Samples& samples = found->second;
+            double maxValue = samples.milliseconds.empty() ? 0.0
+                : *std::max_element(samples.milliseconds.begin(), samples.milliseconds.end());
+            std::printf("%-10d %-8s %6zu %10.1f %10.1f %10.1f %9d\n",
+                        intervalEntry.first, event, samples.milliseconds.size(),
+                        Percentile(samples.milliseconds, 0.50), Percentile(samples.milliseconds, 0.99),
+                        maxValue, samples.timeouts);
+            anyTimeouts = anyTimeouts || samples.timeouts > 0;
+        }
+    }
+
+    return anyTimeouts ? 1 : 0;
+}
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "mock_discord_server.h"
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    bool ReadExact(int fd, char* buffer, size_t length, const std::atomic<bool>& running) {
+        size_t done = 0;
+        while (done < length) {
+            pollfd pfd{fd, POLLIN, 0};
+            int ready = poll(&pfd, 1, 50);
+            if (!running.load()) return false;
+            if (ready <= 0) continue;
+
+            ssize_t result = read(fd, buffer + done, length - done);
+            if (result <= 0) return false;
+            done += static_cast<size_t>(result);
+        }
+        return true;
+    }
+
+    bool WriteFrame(int fd, uint32_t opcode, const std::string& payload) {
+        char header[8];
+        uint32_t length = static_cast<uint32_t>(payload.size());
+        std::memcpy(header, &opcode, 4);     // little-endian hosts only, fine for a bench
+        std::memcpy(header + 4, &length, 4);
+        std::string frame(header, sizeof(header));
+        frame += payload;
+        return write(fd, frame.data(), frame.size()) == static_cast<ssize_t>(frame.size());
+    }
+}
+
+MockDiscordServer::MockDiscordServer(const std::string& socketPath)
+    : socketPath(socketPath) {}
+
+MockDiscordServer::~MockDiscordServer() {
+    Stop();
+}
+
+bool MockDiscordServer::Start() {
+    unlink(socketPath.c_str());
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) return false;
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(listenFd, 4) != 0) {
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    running.store(true);
+    acceptThread = std::thread(&MockDiscordServer::AcceptLoop, this);
+    return true;
+}
+
+void MockDiscordServer::Stop() {
+    if (!running.exchange(false)) return;
+    if (acceptThread.joinable()) acceptThread.join();
+    close(listenFd);
+    listenFd = -1;
+    unlink(socketPath.c_str());
+}
+
+void MockDiscordServer::AcceptLoop() {
+    std::thread client;
+    while (running.load()) {
+        pollfd pfd{listenFd, POLLIN, 0};
+        if (poll(&pfd, 1, 50) <= 0) continue;
+
+        int clientFd = accept(listenFd, nullptr, nullptr);
+        if (clientFd < 0) continue;
+
+        // One client at a time is all the harness needs; a new connection
+        // (app restart) replaces the previous one
+        if (client.joinable()) client.join();
+        client = std::thread(&MockDiscordServer::ServeClient, this, clientFd);
+    }
+    if (client.joinable()) client.join();
+}
+
+void MockDiscordServer::ServeClient(int clientFd) {
+    char header[8];
+    while (ReadExact(clientFd, header, sizeof(header), running)) {
+        uint32_t opcode;
+        uint32_t length;
+        std::memcpy(&opcode, header, 4);
+        std::memcpy(&length, header + 4, 4);
+
+        std::string payload(length, '\0');
+        if (length > 0 && !ReadExact(clientFd, &payload[0], length, running)) break;
+        auto received = Clock::now();
+
+        if (opcode == 0) {
+            WriteFrame(clientFd, 1, "{\"cmd\":\"DISPATCH\",\"evt\":\"READY\",\"data\":{\"v\":1}}");
+            std::lock_guard<std::mutex> lock(mutex);
+            ++readyConnections;
+            condition.notify_all();
+        } else if (opcode == 1 && payload.find("\"SET_ACTIVITY\"") != std::string::npos) {
+            activityCount.fetch_add(1);
+            std::lock_guard<std::mutex> lock(mutex);
+            frames.push_back({received, std::move(payload)});
+            condition.notify_all();
+        } else if (opcode == 2) {
+            break;
+        }
+    }
+    close(clientFd);
+}
+
+bool MockDiscordServer::WaitForActivity(const std::function<bool(const std::string&)>& predicate,
+                                        std::chrono::milliseconds timeout, Frame& out) {
+    auto deadline = Clock::now() + timeout;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        while (!frames.empty()) {
+            Frame frame = std::move(frames.front());
+            frames.pop_front();
+            if (predicate(frame.payload)) {
+                out = std::move(frame);
+                return true;
+            }
+        }
+        if (condition.wait_until(lock, deadline) == std::cv_status::timeout && frames.empty()) {
+            return false;
+        }
+    }
+}
+
+bool MockDiscordServer::WaitForConnections(int count, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex);
+    return condition.wait_for(lock, timeout, [&] { return readyConnections >= count; });
+}
+
+void MockDiscordServer::DiscardPending() {
+    std::lock_guard<std::mutex> lock(mutex);
+    frames.clear();
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Local stand-in for the Discord client: accepts discord-ipc connections,
+// answers the handshake with READY and timestamps every SET_ACTIVITY frame.
+class MockDiscordServer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Frame {
+        Clock::time_point received;
+        std::string payload;
+    };
+
+    explicit MockDiscordServer(const std::string& socketPath);
+    ~MockDiscordServer();
+
+    bool Start();
+    void Stop();
+
+    // Waits for the next SET_ACTIVITY frame matching the predicate, discarding
+    // non-matching ones. Returns false on timeout.
+    bool WaitForActivity(const std::function<bool(const std::string&)>& predicate,
+                         std::chrono::milliseconds timeout, Frame& out);
+    // Waits until at least `count` handshakes have completed since Start()
+    bool WaitForConnections(int count, std::chrono::milliseconds timeout);
+    void DiscardPending();
+
+    size_t GetActivityCount() const { return activityCount.load(); }
+
+private:
+    void AcceptLoop();
+    void ServeClient(int clientFd);
+
+    std::string socketPath;
+    int listenFd = -1;
+    std::atomic<bool> running{false};
+    std::atomic<size_t> activityCount{0};
+    std::thread acceptThread;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<Frame> frames;
+    int readyConnections = 0;
+};
\ No newline at end of file
@@ -0,0 +1,371 @@
+// Long-run soak: millions of back-to-back detection cycles through the real
+// FLStudioDiscordApp pipeline (detector, renderer, presence bus, Discord IPC
+// to a mock endpoint) against simulated process churn: FL Studio starting and
+// exiting, project switches, title flapping, background processes coming and
+// going. Counts heap allocations per cycle on the loop thread, live heap
+// blocks and RSS over time, and fails when the steady state exceeds the
+// thresholds.
+//
+//   soak_test [--cycles N] [--warmup N] [--seed S] [--max-allocs-per-cycle X]
+//             [--max-live-growth N] [--max-rss-growth-kb K]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "config.h"
+#include "discord_client.h"
+#include "fl_studio_detector.h"
+#include "logger.h"
+#include "mock_discord_server.h"
+
+// Live blocks across all threads; allocations per cycle on the counting thread
+static std::atomic<uint64_t> g_allocations{0};
+static std::atomic<uint64_t> g_frees{0};
+static thread_local uint64_t t_allocations = 0;
+static thread_local bool t_paused = false;
+
+namespace {
+    void* Allocate(size_t size) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        if (!t_paused) ++t_allocations;
+        if (void* p = std::malloc(size ? size : 1)) return p;
+        throw std::bad_alloc();
+    }
+
+    void Free(void* p) {
+        if (!p) return;
+        g_frees.fetch_add(1, std::memory_order_relaxed);
+        std::free(p);
+    }
+}
+
+void* operator new(size_t size) { return Allocate(size); }
+void* operator new[](size_t size) { return Allocate(size); }
+void operator delete(void* p) noexcept { Free(p); }
+void operator delete[](void* p) noexcept { Free(p); }
+void operator delete(void* p, size_t) noexcept { Free(p); }
+void operator delete[](void* p, size_t) noexcept { Free(p); }
+
+namespace {
+    constexpr int BACKGROUND_PROCESSES = 250;
+    constexpr int PROJECT_COUNT = 48;
+    constexpr uint64_t WINDOW_CYCLES = 10000;
+
+    // Keeps the harness's own allocations out of the per-cycle count
+    struct PauseCounting {
+        PauseCounting() { t_paused = true; }
+        ~PauseCounting() { t_paused = false; }
+    };
+
+    size_t ReadRssKb() {
+        FILE* statm = std::fopen("/proc/self/statm", "r");
+        if (!statm) return 0;
+        unsigned long size = 0;
+        unsigned long resident = 0;
+        int fields = std::fscanf(statm, "%lu %lu", &size, &resident);
+        std::fclose(statm);
+        return fields == 2 ? resident * static_cast<size_t>(sysconf(_SC_PAGESIZE)) / 1024 : 0;
+    }
+
+    // Process table and FL Studio window title, advanced one step per cycle
+    class ChurnSimulator {
+    public:
+        explicit ChurnSimulator(uint32_t seed) : rng(seed) {
+            background.resize(BACKGROUND_PROCESSES);
+            for (auto& process : background) {
+                Respawn(process);
+            }
+        }
+
+        void Step() {
+            // Background churn: a process exits, another starts
+            if (Chance(0.05)) {
+                std::uniform_int_distribution<size_t> pick(0, background.size() - 1);
+                Respawn(background[pick(rng)]);
+            }
+
+            if (!flRunning) {
+                if (Chance(0.02)) {
+                    flRunning = true;
+                    flPid = nextPid++;
+                    project = Pick(PROJECT_COUNT);
+                    unsaved = false;
+                    ++starts;
+                }
+                return;
+            }
+
+            if (Chance(0.002)) {
+                flRunning = false;
+                return;
+            }
+            flapping = false;
+            if (Chance(0.01)) {
+                project = Pick(PROJECT_COUNT);
+                unsaved = false;
+                ++switches;
+            } else if (Chance(0.03)) {
+                unsaved = !unsaved;
+            } else if (Chance(0.01)) {
+                flapping = true;  // One cycle without a project in the title
+                ++flaps;
+            }
+        }
+
+        std::vector<ProcessInfo> GetProcesses() const {
+            std::vector<ProcessInfo> processes;
+            processes.reserve(background.size() + 1);
+            processes.assign(background.begin(), background.end());
+            if (flRunning) {
+                ProcessInfo fl;
+                fl.pid = flPid;
+                fl.name = "FL64.exe";
+                fl.executablePath = "C:\\Program Files\\Image-Line\\FL Studio 21\\FL64.exe";
+                processes.push_back(std::move(fl));
+            }
+            return processes;
+        }
+
+        std::string GetWindowTitle(int pid) const {
+            if (!flRunning || pid != flPid) return std::string();
+            if (flapping) return "FL Studio 21";
+            std::string title = "FL Studio 21 - Soak Project " + std::to_string(project) + ".flp";
+            if (unsaved) title += " *";
+            return title;
+        }
+
+        uint64_t starts = 0;
+        uint64_t switches = 0;
+        uint64_t flaps = 0;
+
+    private:
+        bool Chance(double probability) { return std::uniform_real_distribution<double>(0.0, 1.0)(rng) < probability; }
+        int Pick(int count) { return std::uniform_int_distribution<int>(0, count - 1)(rng); }
+
+        void Respawn(ProcessInfo& process) {
+            process.pid = nextPid++;
+            process.name = "process" + std::to_string(process.pid % 97);
+            process.executablePath = "/usr/bin/" + process.name;
+        }
+
+        std::mt19937 rng;
+        std::vector<ProcessInfo> background;
+        int nextPid = 1000;
+        bool flRunning = false;
+        int flPid = 0;
+        int project = 0;
+        bool unsaved = false;
+        bool flapping = false;
+    };
+
+    struct Measurements {
+        uint64_t cycles = 0;
+        uint64_t lastAllocations = 0;
+        uint64_t windowAllocations = 0;
+        uint64_t steadyAllocations = 0;
+        uint64_t steadyCycles = 0;
+        double maxWindowAverage = 0.0;
+        uint64_t maxCycleAllocations = 0;
+        uint64_t worstCycle = 0;
+        int64_t baselineLive = 0;
+        int64_t maxLiveGrowth = 0;
+        size_t baselineRssKb = 0;
+        size_t maxRssGrowthKb = 0;
+        size_t finalRssKb = 0;
+        int64_t finalLive = 0;
+    };
+
+    int64_t LiveBlocks() {
+        return static_cast<int64_t>(g_allocations.load(std::memory_order_relaxed)) -
+               static_cast<int64_t>(g_frees.load(std::memory_order_relaxed));
+    }
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t cycles = 2000000;
+    uint64_t warmup = 100000;
+    uint32_t seed = 12345;
+    double maxAllocsPerCycle = 8.0;
+    int64_t maxLiveGrowth = 256;
+    size_t maxRssGrowthKb = 2048;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--cycles") == 0 && i + 1 < argc) {
+            cycles = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            warmup = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--max-allocs-per-cycle") == 0 && i + 1 < argc) {
+            maxAllocsPerCycle = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-live-growth") == 0 && i + 1 < argc) {
+            maxLiveGrowth = std::atoll(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-rss-growth-kb") == 0 && i + 1 < argc) {
+            maxRssGrowthKb = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--cycles N] [--warmup N] [--seed S] [--max-allocs-per-cycle X]"
+                      << " [--max-live-growth N] [--max-rss-growth-kb K]" << std::endl;
+            return 2;
+        }
+    }
+    // Whole windows only, so every steady-state window is complete
+    warmup = (warmup + WINDOW_CYCLES - 1) / WINDOW_CYCLES * WINDOW_CYCLES;
+    if (cycles <= warmup) {
+        std::cerr << "--cycles must exceed --warmup (" << warmup << ")" << std::endl;
+        return 2;
+    }
+
+    // Private runtime dir so the app finds our mock instead of a real Discord
+    char dirTemplate[] = "/tmp/flrpc-soak-XXXXXX";
+    const char* runtimeDir = mkdtemp(dirTemplate);
+    if (!runtimeDir) {
+        std::perror("mkdtemp");
+        return 1;
+    }
+    setenv("XDG_RUNTIME_DIR", runtimeDir, 1);
+    std::string overlayPath = std::string(runtimeDir) + "/overlay.txt";
+
+    MockDiscordServer server(std::string(runtimeDir) + "/discord-ipc-0");
+    if (!server.Start()) {
+        std::cerr << "Failed to start mock Discord server" << std::endl;
+        return 1;
+    }
+
+    // Cycles back to back, no budget stretching, every queued sink in use.
+    // The shared-state export stays off so a daemon on this machine keeps its segment.
+    AppConfig config;
+    config.cpuBudgetPercent = 0.0;
+    config.enableLogging = false;
+    config.overlayFile = overlayPath;
+    config.activityLogFile = "/dev/null";
+    config.exportSharedState = false;
+
+    ChurnSimulator simulator(seed);
+    Measurements measured;
+    FLStudioDiscordApp app(config.applicationId);
+    app.ApplyConfig(config);
+    app.SetUpdateInterval(std::chrono::milliseconds(0));  // Below what a config may set
+
+    // The process source runs once per cycle on the loop thread: everything
+    // allocated on that thread since the previous call belongs to one cycle
+    app.GetDetector().SetProcessSource([&]() {
+        PauseCounting pause;
+        Measurements& m = measured;
+        uint64_t allocations = t_allocations - m.lastAllocations;
+        if (m.cycles > 0) {
+            m.windowAllocations += allocations;
+            if (m.cycles > warmup) {
+                m.steadyAllocations += allocations;
+                ++m.steadyCycles;
+                if (allocations > m.maxCycleAllocations) {
+                    m.maxCycleAllocations = allocations;
+                    m.worstCycle = m.cycles;
+                }
+            }
+        }
+
+        if (m.cycles % WINDOW_CYCLES == 0 && m.cycles > 0) {
+            double average = static_cast<double>(m.windowAllocations) / WINDOW_CYCLES;
+            m.windowAllocations = 0;
+            server.DiscardPending();
+
+            size_t rssKb = ReadRssKb();
+            int64_t live = LiveBlocks();
+            if (m.cycles == warmup) {
+                m.baselineRssKb = rssKb;
+                m.baselineLive = live;
+            } else if (m.cycles > warmup) {
+                m.maxWindowAverage = std::max(m.maxWindowAverage, average);
+                m.maxLiveGrowth = std::max(m.maxLiveGrowth, live - m.baselineLive);
+                if (rssKb > m.baselineRssKb) {
+                    m.maxRssGrowthKb = std::max(m.maxRssGrowthKb, rssKb - m.baselineRssKb);
+                }
+            }
+            m.finalRssKb = rssKb;
+            m.finalLive = live;
+            if (m.cycles % (WINDOW_CYCLES * 20) == 0) {
+                std::printf("%10llu cycles  %6.2f allocs/cycle  %8lld live blocks  %8zu KB RSS\n",
+                            static_cast<unsigned long long>(m.cycles), average, static_cast<long long>(live), rssKb);
+                std::fflush(stdout);
+            }
+        }
+
+        if (++m.cycles > cycles) {
+            app.Stop();  // On the loop thread: Run() returns after this cycle
+        }
+        simulator.Step();
+        auto processes = simulator.GetProcesses();
+        m.lastAllocations = t_allocations;
+        return processes;
+    });
+    app.GetDetector().SetWindowTitleSource([&](int pid) {
+        PauseCounting pause;
+        return simulator.GetWindowTitle(pid);
+    });
+
+    if (!app.Initialize()) {
+        std::cerr << "Failed to initialize app" << std::endl;
+        return 1;
+    }
+    auto started = std::chrono::steady_clock::now();
+    std::thread runner([&app] { app.Run(); });
+    runner.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    auto debounce = app.GetDebounceStats();
+    uint64_t suppressed = debounce.project.suppressed + debounce.unsaved.suppressed + debounce.playback.suppressed +
+                          debounce.recording.suppressed;
+
+    size_t activities = server.GetActivityCount();
+    server.Stop();
+    unlink(overlayPath.c_str());
+    rmdir(runtimeDir);
+    Logger::Instance().Shutdown();
+
+    double steadyAverage = measured.steadyCycles > 0
+        ? static_cast<double>(measured.steadyAllocations) / measured.steadyCycles : 0.0;
+    std::printf("\n%llu cycles in %.1f s (%.1f us/cycle), %llu FL starts, %llu project switches, %llu title flaps, "
+                "%zu SET_ACTIVITY frames\n",
+                static_cast<unsigned long long>(cycles), seconds, seconds * 1e6 / cycles,
+                static_cast<unsigned long long>(simulator.starts), static_cast<unsigned long long>(simulator.switches),
+                static_cast<unsigned long long>(simulator.flaps), activities);
+    std::printf("%llu transient state(s) debounced: project %llu, unsaved %llu\n",
+                static_cast<unsigned long long>(suppressed), static_cast<unsigned long long>(debounce.project.suppressed),
+                static_cast<unsigned long long>(debounce.unsaved.suppressed));
+    std::printf("steady state after %llu cycles:\n", static_cast<unsigned long long>(warmup));
+    std::printf("  allocations per cycle  %.2f avg, %.2f worst window, %llu in cycle %llu (limit %.2f)\n",
+                steadyAverage, measured.maxWindowAverage, static_cast<unsigned long long>(measured.maxCycleAllocations),
+                static_cast<unsigned long long>(measured.worstCycle), maxAllocsPerCycle);
+    std::printf("  live heap blocks       %+lld peak, %+lld at end (limit %lld)\n",
+                static_cast<long long>(measured.maxLiveGrowth),
+                static_cast<long long>(measured.finalLive - measured.baselineLive), static_cast<long long>(maxLiveGrowth));
+    std::printf("  RSS                    %zu KB at warmup, +%zu KB peak, %zu KB at end (limit +%zu KB)\n",
+                measured.baselineRssKb, measured.maxRssGrowthKb, measured.finalRssKb, maxRssGrowthKb);
+
+    bool failed = false;
+    if (measured.maxWindowAverage > maxAllocsPerCycle) {
+        std::printf("FAIL: allocations per cycle over the limit\n");
+        failed = true;
+    }
+    if (measured.maxLiveGrowth > maxLiveGrowth) {
+        std::printf("FAIL: live heap blocks keep growing (leak)\n");
+        failed = true;
+    }
+    if (measured.maxRssGrowthKb > maxRssGrowthKb) {
+        std::printf("FAIL: RSS grew past the limit (leak or fragmentation)\n");
+        failed = true;
+    }
+    if (!failed) {
+        std::printf("PASS\n");
+    }
+    return failed ? 1 : 0;
+}
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <string>
 #include <chrono>
 #include <ctime>
+#include <vector>
 
 struct ProcessInfo {
     int pid = 0;
@@ -19,6 +20,8 @@ struct FLStudioInfo {
     std::string version = "FL Studio";
     std::string windowTitle;
     std::string executablePath;  // Add this missing member
+    std::vector<std::string> recentProjects;  // Host paths, newest first (Wine only)
+    std::vector<std::string> plugins;         // Known plugins loaded (Linux only)
     
     // State
     bool isRunning = false;
@@ -46,7 +49,8 @@ struct FLStudioInfo {
                isRecording != other.isRecording ||
                isPaused != other.isPaused ||
                isRunning != other.isRunning ||
-               hasUnsavedChanges != other.hasUnsavedChanges;
+               hasUnsavedChanges != other.hasUnsavedChanges ||
+               plugins != other.plugins;
     }
 };
 
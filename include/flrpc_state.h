@@ -0,0 +1,106 @@
+/* flrpc_state.h - current FL Studio state in shared memory
+ *
+ * The daemon keeps one fixed-layout record in a shared-memory segment and
+ * rewrites it every detection cycle. Readers map it read-only; a seqlock
+ * gives them a consistent copy without system calls or locks: the writer
+ * makes `sequence` odd, updates the payload, then makes it even again, and
+ * a reader retries whenever it saw an odd value or the value changed while
+ * it copied.
+ *
+ * Plain C so tools in any language with a C FFI can read it. Link the
+ * flrpc_state_reader library, or implement the protocol directly from the
+ * layout below.
+ */
+#ifndef FLRPC_STATE_H
+#define FLRPC_STATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FLRPC_STATE_MAGIC 0x53524C46u   /* "FLRS" */
+#define FLRPC_STATE_VERSION 1u
+
+/* POSIX: "/flrpc-state-<uid>", one segment per user. Windows: "Local\flrpc-state". */
+#define FLRPC_STATE_NAME_PREFIX "/flrpc-state-"
+#define FLRPC_STATE_WINDOWS_NAME "Local\\flrpc-state"
+
+/* flrpc_state.flags */
+#define FLRPC_STATE_RUNNING   (1u << 0)
+#define FLRPC_STATE_PLAYING   (1u << 1)
+#define FLRPC_STATE_RECORDING (1u << 2)
+#define FLRPC_STATE_PAUSED    (1u << 3)
+#define FLRPC_STATE_IDLE      (1u << 4)
+#define FLRPC_STATE_UNSAVED   (1u << 5)
+
+/* flrpc_state.activity, the state presence is rendered from */
+enum flrpc_activity {
+    FLRPC_ACTIVITY_NOT_RUNNING = 0,
+    FLRPC_ACTIVITY_IDLE = 1,
+    FLRPC_ACTIVITY_COMPOSING = 2,
+    FLRPC_ACTIVITY_PLAYING = 3,
+    FLRPC_ACTIVITY_RECORDING = 4,
+    FLRPC_ACTIVITY_PAUSED = 5
+};
+
+typedef struct flrpc_state {
+    /* Header, fixed while the segment exists */
+    uint32_t magic;
+    uint32_t version;          /* Layout changes bump this */
+    uint32_t size;             /* sizeof(flrpc_state) as the writer built it */
+    uint32_t writer_pid;
+
+    /* Seqlock: odd while an update is in progress */
+    uint64_t sequence;
+
+    /* Payload */
+    uint64_t updates;          /* Publishes since the daemon started */
+    int64_t updated_ms;        /* Unix time of the last publish, milliseconds */
+    int64_t session_start;     /* Unix time FL Studio was first seen, seconds */
+    int32_t pid;               /* FL Studio process, 0 when not running */
+    int32_t bpm;               /* 0 when unknown */
+    int32_t pattern;           /* 0 when unknown */
+    uint32_t flags;            /* FLRPC_STATE_* */
+    uint32_t activity;         /* enum flrpc_activity */
+    uint32_t reserved;
+
+    /* UTF-8, always NUL-terminated, cut to fit */
+    char project[256];
+    char fl_version[64];       /* e.g. "FL Studio 21" */
+    char window_title[256];
+    char plugins[512];         /* Known loaded plugins, ", "-separated */
+} flrpc_state;
+
+/* Reader */
+#define FLRPC_STATE_OK 0
+#define FLRPC_STATE_UNAVAILABLE (-1)   /* No segment, or an incompatible layout */
+#define FLRPC_STATE_BUSY (-2)          /* Writer kept updating; try again */
+
+typedef struct flrpc_state_reader {
+    const volatile flrpc_state* shared;
+    void* handle;              /* Platform mapping handle */
+} flrpc_state_reader;
+
+/* The calling user's segment name (POSIX); returns 0 on success */
+int flrpc_state_default_name(char* buffer, size_t size);
+
+/* Maps the segment read-only. name NULL means the default for this user. */
+int flrpc_state_open(flrpc_state_reader* reader, const char* name);
+
+/* Copies a consistent snapshot into out. No system calls, no locks. */
+int flrpc_state_read(const flrpc_state_reader* reader, flrpc_state* out);
+
+/* Current sequence number: unchanged means nothing was published since.
+ * Cheaper than a full read for polling loops. */
+uint64_t flrpc_state_sequence(const flrpc_state_reader* reader);
+
+void flrpc_state_close(flrpc_state_reader* reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FLRPC_STATE_H */
\ No newline at end of file
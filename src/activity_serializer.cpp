@@ -0,0 +1,84 @@
+#include "activity_serializer.h"
+#include <charconv>
+
+namespace {
+    void WriteNonce(JsonWriter& writer, uint64_t nonce) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), nonce);
+        writer.Key("nonce");
+        writer.String(std::string_view(digits, static_cast<size_t>(result.ptr - digits)));
+    }
+}
+
+void WriteHandshake(JsonWriter& writer, std::string_view clientId) {
+    writer.Reset();
+    writer.BeginObject();
+    writer.Key("v");
+    writer.Int(1);
+    writer.Key("client_id");
+    writer.String(clientId);
+    writer.EndObject();
+}
+
+void WriteSetActivity(JsonWriter& writer, int pid, const RenderedPresence& presence, uint64_t nonce) {
+    writer.Reset();
+    writer.BeginObject();
+    writer.Key("cmd");
+    writer.String("SET_ACTIVITY");
+
+    writer.Key("args");
+    writer.BeginObject();
+    writer.Key("pid");
+    writer.Int(pid);
+
+    // Omitting the activity clears it
+    if (presence.active) {
+        writer.Key("activity");
+        writer.BeginObject();
+
+        writer.Key("details");
+        writer.String(presence.details.View());
+        writer.Key("state");
+        writer.String(presence.state.View());
+
+        if (presence.startTimestamp > 0) {
+            writer.Key("timestamps");
+            writer.BeginObject();
+            writer.Key("start");
+            writer.Int(static_cast<int64_t>(presence.startTimestamp));
+            writer.EndObject();
+        }
+
+        writer.Key("assets");
+        writer.BeginObject();
+        writer.Key("large_image");
+        writer.String(presence.largeImage);
+        writer.Key("large_text");
+        writer.String(presence.largeText.View());
+        writer.Key("small_image");
+        writer.String(presence.smallImage);
+        writer.Key("small_text");
+        writer.String(presence.smallText);
+        writer.EndObject();
+
+        if (presence.buttonCount > 0) {
+            writer.Key("buttons");
+            writer.BeginArray();
+            for (size_t i = 0; i < presence.buttonCount; ++i) {
+                writer.BeginObject();
+                writer.Key("label");
+                writer.String(presence.buttons[i].label.View());
+                writer.Key("url");
+                writer.String(presence.buttons[i].url.View());
+                writer.EndObject();
+            }
+            writer.EndArray();
+        }
+
+        writer.EndObject();
+    }
+
+    writer.EndObject();
+    WriteNonce(writer, nonce);
+    writer.EndObject();
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include "json_writer.h"
+#include "presence_renderer.h"
+
+// Discord RPC payloads, serialized straight from the rendered presence into a
+// reusable JsonWriter (no intermediate strings)
+void WriteHandshake(JsonWriter& writer, std::string_view clientId);
+void WriteSetActivity(JsonWriter& writer, int pid, const RenderedPresence& presence, uint64_t nonce);
\ No newline at end of file
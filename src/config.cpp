@@ -1,6 +1,6 @@
 #include "config.h"
+#include "logger.h"
 #include <fstream>
-#include <iostream>
 #include <filesystem>
 
 #ifdef _WIN32
@@ -14,51 +14,229 @@
     #include <pwd.h>
 #endif
 
-// Simple JSON-like parser (you might want to use a real JSON library)
 #include <sstream>
-#include <map>
+#include <cerrno>
+#include <cstdlib>
+
+namespace {
+    std::string Trim(const std::string& text) {
+        size_t begin = text.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) return "";
+        size_t end = text.find_last_not_of(" \t\r");
+        return text.substr(begin, end - begin + 1);
+    }
+    
+    bool ParseBool(const std::string& value, bool& out) {
+        if (value == "true") { out = true; return true; }
+        if (value == "false") { out = false; return true; }
+        return false;
+    }
+    
+    bool ParseInteger(const std::string& value, long long& out) {
+        if (value.empty()) return false;
+        char* end = nullptr;
+        errno = 0;
+        long long parsed = std::strtoll(value.c_str(), &end, 10);
+        if (errno != 0 || *end != '\0') return false;
+        out = parsed;
+        return true;
+    }
+    
+    bool ParseDecimal(const std::string& value, double& out) {
+        if (value.empty()) return false;
+        char* end = nullptr;
+        errno = 0;
+        double parsed = std::strtod(value.c_str(), &end);
+        if (errno != 0 || *end != '\0') return false;
+        out = parsed;
+        return true;
+    }
+    
+    bool IsHttpUrl(const std::string& url) {
+        return url.rfind("https://", 0) == 0 || url.rfind("http://", 0) == 0;
+    }
+    
+    // Debounce hold times, in milliseconds
+    const std::pair<const char*, std::chrono::milliseconds AppConfig::*> HOLD_FIELDS[] = {
+        {"debounceProject", &AppConfig::debounceProject},
+        {"debounceUnsaved", &AppConfig::debounceUnsaved},
+        {"debouncePlayback", &AppConfig::debouncePlayback},
+        {"debounceRecordingEnd", &AppConfig::debounceRecordingEnd}
+    };
+}
+
+bool AppConfig::Parse(std::istream& input, AppConfig& config, std::string& errors) {
+    size_t errorsBefore = errors.size();
+    
+    // Boolean and string settings, in declaration order
+    const std::pair<const char*, bool AppConfig::*> boolFields[] = {
+        {"enableRichPresence", &AppConfig::enableRichPresence},
+        {"showProjectName", &AppConfig::showProjectName},
+        {"showProjectPath", &AppConfig::showProjectPath},
+        {"showBPM", &AppConfig::showBPM},
+        {"showPlaybackState", &AppConfig::showPlaybackState},
+        {"showUnsavedChanges", &AppConfig::showUnsavedChanges},
+        {"exportSharedState", &AppConfig::exportSharedState},
+        {"enableAdvancedDetection", &AppConfig::enableAdvancedDetection},
+        {"enableAudioDetection", &AppConfig::enableAudioDetection},
+        {"enableCustomButtons", &AppConfig::enableCustomButtons},
+        {"minimizeToTray", &AppConfig::minimizeToTray},
+        {"startWithSystem", &AppConfig::startWithSystem},
+        {"showNotifications", &AppConfig::showNotifications},
+        {"enableLogging", &AppConfig::enableLogging}
+    };
+    const std::pair<const char*, std::string AppConfig::*> stringFields[] = {
+        {"applicationId", &AppConfig::applicationId},
+        {"discordSdkPath", &AppConfig::discordSdkPath},
+        {"overlayFile", &AppConfig::overlayFile},
+        {"activityLogFile", &AppConfig::activityLogFile},
+        {"recordingFolder", &AppConfig::recordingFolder},
+        {"customButton1Label", &AppConfig::customButton1Label},
+        {"customButton1Url", &AppConfig::customButton1Url},
+        {"customButton2Label", &AppConfig::customButton2Label},
+        {"customButton2Url", &AppConfig::customButton2Url},
+        {"customIdleMessage", &AppConfig::customIdleMessage},
+        {"customComposingMessage", &AppConfig::customComposingMessage},
+        {"customPlayingMessage", &AppConfig::customPlayingMessage},
+        {"customRecordingMessage", &AppConfig::customRecordingMessage}
+    };
+    
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(input, line)) {
+        ++lineNumber;
+        std::string trimmed = Trim(line);
+        if (trimmed.empty() || trimmed[0] == '#') continue;
+        
+        // Simple key=value parser
+        size_t equalPos = trimmed.find('=');
+        if (equalPos == std::string::npos) {
+            errors += "line " + std::to_string(lineNumber) + ": expected key=value\n";
+            continue;
+        }
+        std::string key = Trim(trimmed.substr(0, equalPos));
+        std::string value = Trim(trimmed.substr(equalPos + 1));
+        
+        // Remove quotes if present
+        if (value.length() >= 2 && value.front() == '"' && value.back() == '"') {
+            value = value.substr(1, value.length() - 2);
+        }
+        
+        auto fail = [&](const char* expected) {
+            errors += "line " + std::to_string(lineNumber) + ": " + key + " expects " + expected +
+                      ", got '" + value + "'\n";
+        };
+        
+        bool known = false;
+        for (const auto& field : boolFields) {
+            if (key == field.first) {
+                known = true;
+                if (!ParseBool(value, config.*field.second)) fail("true or false");
+                break;
+            }
+        }
+        for (const auto& field : stringFields) {
+            if (known) break;
+            if (key == field.first) {
+                known = true;
+                config.*field.second = value;
+            }
+        }
+        long long number = 0;
+        for (const auto& field : HOLD_FIELDS) {
+            if (known) break;
+            if (key == field.first) {
+                known = true;
+                if (ParseInteger(value, number)) config.*field.second = std::chrono::milliseconds(number);
+                else fail("milliseconds");
+            }
+        }
+        if (known) continue;
+        
+        if (key == "updateInterval") {
+            if (ParseInteger(value, number)) config.updateInterval = std::chrono::milliseconds(number);
+            else fail("milliseconds");
+        }
+        else if (key == "presenceTimeout") {
+            if (ParseInteger(value, number)) config.presenceTimeout = std::chrono::seconds(number);
+            else fail("seconds");
+        }
+        else if (key == "webSocketPort") {
+            if (ParseInteger(value, number)) config.webSocketPort = number >= 0 && number <= 65535 ? static_cast<int>(number) : -1;
+            else fail("a port number");
+        }
+        else if (key == "cpuBudgetPercent") {
+            if (!ParseDecimal(value, config.cpuBudgetPercent)) fail("a percentage of one core");
+        }
+        else if (key == "hiddenProject") config.hiddenProjects.push_back(value);
+        else if (key == "hiddenProjects") {
+            // Comma-separated shorthand; use one hiddenProject= line per rule
+            // when a pattern itself needs a comma
+            std::stringstream list(value);
+            std::string rule;
+            while (std::getline(list, rule, ',')) {
+                if (rule.find_first_not_of(" \t") != std::string::npos) {
+                    config.hiddenProjects.push_back(rule);
+                }
+            }
+        }
+        else if (key == "webSocketOrigin") config.webSocketOrigins.push_back(value);
+        else if (key == "webSocketOrigins") {
+            std::stringstream list(value);
+            std::string origin;
+            while (std::getline(list, origin, ',')) {
+                if (origin.find_first_not_of(" \t") != std::string::npos) {
+                    config.webSocketOrigins.push_back(origin);
+                }
+            }
+        }
+        else if (key == "processName") config.processNames.push_back(value);
+        else if (key == "processNames") {
+            std::stringstream list(value);
+            std::string name;
+            while (std::getline(list, name, ',')) {
+                if (name.find_first_not_of(" \t") != std::string::npos) {
+                    config.processNames.push_back(name);
+                }
+            }
+        }
+        else {
+            errors += "line " + std::to_string(lineNumber) + ": unknown key '" + key + "'\n";
+        }
+    }
+    
+    return errors.size() == errorsBefore;
+}
+
+bool AppConfig::LoadFile(const std::string& path, AppConfig& config, std::string& errors) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        errors += "cannot open " + path + "\n";
+        return false;
+    }
+    return Parse(file, config, errors);
+}
 
 AppConfig AppConfig::Load(const std::string& configPath) {
     AppConfig config;
-    std::string path = configPath.empty() ? GetDefaultConfigPath() : configPath;
+    std::string path = ResolvePath(configPath);
     
     try {
         if (std::filesystem::exists(path)) {
-            std::ifstream file(path);
-            if (file.is_open()) {
-                std::string line;
-                while (std::getline(file, line)) {
-                    // Simple key=value parser
-                    size_t equalPos = line.find('=');
-                    if (equalPos != std::string::npos) {
-                        std::string key = line.substr(0, equalPos);
-                        std::string value = line.substr(equalPos + 1);
-                        
-                        // Remove quotes if present
-                        if (value.front() == '"' && value.back() == '"') {
-                            value = value.substr(1, value.length() - 2);
-                        }
-                        
-                        // Parse configuration values
-                        if (key == "applicationId") config.applicationId = value;
-                        else if (key == "enableRichPresence") config.enableRichPresence = (value == "true");
-                        else if (key == "showProjectName") config.showProjectName = (value == "true");
-                        else if (key == "showBPM") config.showBPM = (value == "true");
-                        else if (key == "updateInterval") config.updateInterval = std::chrono::milliseconds(std::stoi(value));
-                        // Add more config parsing as needed
-                    }
-                }
-                file.close();
-                
-                std::cout << "Configuration loaded from: " << path << std::endl;
+            // At startup, bad lines are reported and skipped; the rest still applies
+            std::string errors;
+            if (!LoadFile(path, config, errors)) {
+                LOG_WARNING("Problems in {}:", path);
+                LOG_WARNING_LINES(errors);
             }
+            LOG_INFO("Configuration loaded from: {}", path);
         } else {
-            std::cout << "Config file not found, using defaults: " << path << std::endl;
+            LOG_INFO("Config file not found, using defaults: {}", path);
             config.SetDefaults();
             config.Save(path); // Create default config file
         }
     } catch (const std::exception& e) {
-        std::cerr << "Failed to load config: " << e.what() << std::endl;
+        LOG_ERROR("Failed to load config: {}", e.what());
         config.SetDefaults();
     }
     
@@ -66,7 +244,7 @@ AppConfig AppConfig::Load(const std::string& configPath) {
 }
 
 bool AppConfig::Save(const std::string& configPath) const {
-    std::string path = configPath.empty() ? GetDefaultConfigPath() : configPath;
+    std::string path = ResolvePath(configPath);
     
     try {
         // Create directory if it doesn't exist
@@ -77,7 +255,7 @@ bool AppConfig::Save(const std::string& configPath) const {
         
         std::ofstream file(path);
         if (!file.is_open()) {
-            std::cerr << "Failed to open config file for writing: " << path << std::endl;
+            LOG_ERROR("Failed to open config file for writing: {}", path);
             return false;
         }
         
@@ -85,28 +263,131 @@ bool AppConfig::Save(const std::string& configPath) const {
         file << "# FL Studio Discord Rich Presence Configuration\n";
         file << "applicationId=\"" << applicationId << "\"\n";
         file << "enableRichPresence=" << (enableRichPresence ? "true" : "false") << "\n";
+        file << "discordSdkPath=\"" << discordSdkPath << "\"\n";
         file << "showProjectName=" << (showProjectName ? "true" : "false") << "\n";
+        file << "showProjectPath=" << (showProjectPath ? "true" : "false") << "\n";
         file << "showBPM=" << (showBPM ? "true" : "false") << "\n";
+        file << "showPlaybackState=" << (showPlaybackState ? "true" : "false") << "\n";
+        file << "showUnsavedChanges=" << (showUnsavedChanges ? "true" : "false") << "\n";
         file << "updateInterval=" << updateInterval.count() << "\n";
+        file << "presenceTimeout=" << presenceTimeout.count() << "\n";
+        file << "cpuBudgetPercent=" << cpuBudgetPercent << "\n";
+        for (const auto& field : HOLD_FIELDS) {
+            file << field.first << "=" << (this->*field.second).count() << "\n";
+        }
+        file << "overlayFile=\"" << overlayFile << "\"\n";
+        file << "activityLogFile=\"" << activityLogFile << "\"\n";
+        file << "webSocketPort=" << webSocketPort << "\n";
+        for (const auto& origin : webSocketOrigins) {
+            file << "webSocketOrigin=\"" << origin << "\"\n";
+        }
+        file << "exportSharedState=" << (exportSharedState ? "true" : "false") << "\n";
+        file << "enableAdvancedDetection=" << (enableAdvancedDetection ? "true" : "false") << "\n";
+        file << "enableAudioDetection=" << (enableAudioDetection ? "true" : "false") << "\n";
+        file << "recordingFolder=\"" << recordingFolder << "\"\n";
+        for (const auto& name : processNames) {
+            file << "processName=\"" << name << "\"\n";
+        }
+        file << "minimizeToTray=" << (minimizeToTray ? "true" : "false") << "\n";
+        file << "startWithSystem=" << (startWithSystem ? "true" : "false") << "\n";
+        file << "showNotifications=" << (showNotifications ? "true" : "false") << "\n";
         file << "enableLogging=" << (enableLogging ? "true" : "false") << "\n";
-        // Add more config writing as needed
+        
+        file << "enableCustomButtons=" << (enableCustomButtons ? "true" : "false") << "\n";
+        file << "customButton1Label=\"" << customButton1Label << "\"\n";
+        file << "customButton1Url=\"" << customButton1Url << "\"\n";
+        file << "customButton2Label=\"" << customButton2Label << "\"\n";
+        file << "customButton2Url=\"" << customButton2Url << "\"\n";
+        
+        // Privacy rules: exact name, glob, prefix:, re:, optionally prefixed with path:
+        for (const auto& rule : hiddenProjects) {
+            file << "hiddenProject=\"" << rule << "\"\n";
+        }
+        
+        // Presence templates: {project} {version} {bpm} {pattern} {state} {unsaved} {plugins},
+        // [optional groups] are dropped when a variable inside them is empty
+        file << "customIdleMessage=\"" << customIdleMessage << "\"\n";
+        file << "customComposingMessage=\"" << customComposingMessage << "\"\n";
+        file << "customPlayingMessage=\"" << customPlayingMessage << "\"\n";
+        file << "customRecordingMessage=\"" << customRecordingMessage << "\"\n";
         
         file.close();
-        std::cout << "Configuration saved to: " << path << std::endl;
+        LOG_INFO("Configuration saved to: {}", path);
         return true;
         
     } catch (const std::exception& e) {
-        std::cerr << "Failed to save config: " << e.what() << std::endl;
+        LOG_ERROR("Failed to save config: {}", e.what());
         return false;
     }
 }
 
 bool AppConfig::IsValid() const {
     return !applicationId.empty() && 
-           applicationId != "YOUR_DISCORD_APP_ID_HERE" &&
+           applicationId.find_first_not_of("0123456789") == std::string::npos &&
            updateInterval.count() > 0;
 }
 
+bool AppConfig::Validate(std::string& errors) const {
+    AppConfig checked = *this;
+    return checked.ResetInvalid(errors);
+}
+
+bool AppConfig::ResetInvalid(std::string& errors) {
+    size_t errorsBefore = errors.size();
+    const AppConfig defaults;
+    
+    // Discord application IDs are snowflakes: decimal digits only. There is
+    // no sensible default for someone else's ID, so this one is only reported.
+    if (applicationId.empty() || applicationId.find_first_not_of("0123456789") != std::string::npos) {
+        errors += "applicationId must be the numeric Discord application ID\n";
+    }
+    if (updateInterval < std::chrono::milliseconds(100) || updateInterval > std::chrono::milliseconds(60000)) {
+        errors += "updateInterval must be between 100 and 60000 ms\n";
+        updateInterval = defaults.updateInterval;
+    }
+    if (presenceTimeout < std::chrono::seconds(1) || presenceTimeout > std::chrono::seconds(3600)) {
+        errors += "presenceTimeout must be between 1 and 3600 s\n";
+        presenceTimeout = defaults.presenceTimeout;
+    }
+    for (const auto& field : HOLD_FIELDS) {
+        auto& hold = this->*field.second;
+        if (hold < std::chrono::milliseconds(0) || hold > std::chrono::milliseconds(60000)) {
+            errors += std::string(field.first) + " must be between 0 and 60000 ms\n";
+            hold = defaults.*field.second;
+        }
+    }
+    if (!(cpuBudgetPercent >= 0.0 && cpuBudgetPercent <= 100.0)) {
+        errors += "cpuBudgetPercent must be between 0 and 100\n";
+        cpuBudgetPercent = defaults.cpuBudgetPercent;
+    }
+    if (webSocketPort < 0 || webSocketPort > 65535) {
+        errors += "webSocketPort must be between 1 and 65535, or 0 to disable\n";
+        webSocketPort = defaults.webSocketPort;
+    }
+    
+    const std::pair<std::string*, std::string*> buttons[] = {
+        {&customButton1Label, &customButton1Url},
+        {&customButton2Label, &customButton2Url}
+    };
+    for (const auto& button : buttons) {
+        if (button.first->empty() != button.second->empty()) {
+            errors += "custom buttons need both a label and a URL\n";
+        } else if (!button.second->empty() && !IsHttpUrl(*button.second)) {
+            errors += "custom button URL must start with http:// or https://: " + *button.second + "\n";
+        } else {
+            continue;
+        }
+        button.first->clear();
+        button.second->clear();
+    }
+    
+    return errors.size() == errorsBefore;
+}
+
+std::string AppConfig::ResolvePath(const std::string& configPath) {
+    return configPath.empty() ? GetDefaultConfigPath() : configPath;
+}
+
 void AppConfig::SetDefaults() {
     applicationId = "YOUR_DISCORD_APP_ID_HERE";
     enableRichPresence = true;
@@ -121,6 +402,16 @@ std::string AppConfig::GetDefaultConfigPath() {
     return dir.empty() ? "config.txt" : dir + "/config.txt";
 }
 
+std::string AppConfig::GetLogFilePath() {
+    std::string dir = GetConfigDirectory();
+    return dir.empty() ? "flstudio-rpc.log" : dir + "/flstudio-rpc.log";
+}
+
+std::string AppConfig::GetSessionSnapshotPath() {
+    std::string dir = GetConfigDirectory();
+    return dir.empty() ? "session.snapshot" : dir + "/session.snapshot";
+}
+
 std::string AppConfig::GetConfigDirectory() {
 #ifdef _WIN32
     char* appDataPath;
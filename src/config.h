@@ -3,11 +3,15 @@
 #include <string>
 #include <vector>
 #include <chrono>
+#include <istream>
 
 struct AppConfig {
     // Discord settings
     std::string applicationId = "1395851731312836760";
     bool enableRichPresence = true;
+    // Optional Discord Partner SDK: "" never loads it, "auto" searches the
+    // default locations, anything else is a library path
+    std::string discordSdkPath;
     
     // Privacy settings
     bool showProjectName = true;
@@ -20,11 +24,36 @@ struct AppConfig {
     // Update settings
     std::chrono::milliseconds updateInterval{3000};
     std::chrono::seconds presenceTimeout{30};
+    // Own CPU use allowed, in percent of one core; over it detection degrades
+    // (less enrichment, longer intervals, PID-only checks). 0 disables.
+    double cpuBudgetPercent = 0.1;
+    // How long a transient state must persist before presence shows it; 0
+    // shows that change at once. See StateDebouncer.
+    std::chrono::milliseconds debounceProject{2000};      // Title without a project (file dialogs)
+    std::chrono::milliseconds debounceUnsaved{1500};      // The '*' marker
+    std::chrono::milliseconds debouncePlayback{1500};     // Playing, paused, stopped
+    std::chrono::milliseconds debounceRecordingEnd{3000};
+    
+    // Extra presence outputs next to Discord; empty or 0 disables each
+    std::string overlayFile;       // Details and state lines for an OBS text source
+    std::string activityLogFile;   // JSON Lines, one entry per presence change
+    int webSocketPort = 0;         // ws://127.0.0.1:<port> for stream widgets
+    // Web pages allowed to connect to it, e.g. "http://localhost:8080", or
+    // "null" for a local file (also sent by sandboxed frames on any site).
+    // Non-browser clients send no origin and can always connect.
+    std::vector<std::string> webSocketOrigins;
+    bool exportSharedState = true; // Lock-free shared-memory record, see include/flrpc_state.h
     
     // Advanced features
     bool enableAdvancedDetection = false;
+    std::vector<std::string> processNames;  // Extra names that count as FL Studio
+    std::string recordingFolder;  // Where FL Studio records takes; "" finds Audio/Recorded
     bool enableAudioDetection = false;
     bool enableCustomButtons = true;
+    std::string customButton1Label;
+    std::string customButton1Url;
+    std::string customButton2Label;
+    std::string customButton2Url;
     
     // System settings
     bool minimizeToTray = false;
@@ -41,9 +70,22 @@ struct AppConfig {
     // File operations
     static AppConfig Load(const std::string& configPath = "");
     bool Save(const std::string& configPath = "") const;
+    static std::string ResolvePath(const std::string& configPath = "");
+    static std::string GetLogFilePath();  // Next to the config file, used when enableLogging is set
+    static std::string GetSessionSnapshotPath();  // Next to the config file, for warm starts
+    
+    // Parses key=value lines on top of the fields already in config. Every
+    // declared field is recognised; malformed values and unknown keys are
+    // reported one per line in errors and make the call return false.
+    static bool Parse(std::istream& input, AppConfig& config, std::string& errors);
+    static bool LoadFile(const std::string& path, AppConfig& config, std::string& errors);
     
     // Validation
     bool IsValid() const;
+    bool Validate(std::string& errors) const;  // Range and format checks, one error per line
+    // Same checks, but every failing field is reset to its default (except
+    // applicationId, which has none) and reported; returns false if any failed
+    bool ResetInvalid(std::string& errors);
     void SetDefaults();
     
 private:
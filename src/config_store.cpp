@@ -0,0 +1,67 @@
+#include "config_store.h"
+#include <limits>
+
+ConfigStore::ConfigStore(const AppConfig& initial)
+    : current(new AppConfig(initial)) {
+    for (auto& epoch : readerEpochs) {
+        epoch.store(std::numeric_limits<uint64_t>::max());
+    }
+}
+
+ConfigStore::~ConfigStore() {
+    for (const auto& entry : retired) {
+        delete entry.snapshot;
+    }
+    delete current.load();
+}
+
+ConfigStore::ReaderId ConfigStore::RegisterReader() {
+    int reader = readerCount.fetch_add(1);
+    if (reader >= MAX_READERS) {
+        readerCount.fetch_sub(1);
+        return -1;
+    }
+    readerEpochs[reader].store(version.load());
+    return reader;
+}
+
+void ConfigStore::Quiesce(ReaderId reader) {
+    if (reader < 0 || reader >= MAX_READERS) return;
+    readerEpochs[reader].store(version.load());
+}
+
+void ConfigStore::Publish(std::unique_ptr<const AppConfig> snapshot) {
+    std::lock_guard<std::mutex> lock(writerMutex);
+
+    // Swap first, then bump the version: a reader that quiesces having seen
+    // the new version can no longer load the old pointer
+    const AppConfig* previous = current.exchange(snapshot.release());
+    uint64_t replacedAt = version.fetch_add(1) + 1;
+    retired.push_back({replacedAt, previous});
+
+    Reclaim();
+}
+
+size_t ConfigStore::GetRetiredCount() const {
+    std::lock_guard<std::mutex> lock(writerMutex);
+    return retired.size();
+}
+
+void ConfigStore::Reclaim() {
+    uint64_t oldest = std::numeric_limits<uint64_t>::max();
+    int readers = readerCount.load();
+    for (int i = 0; i < readers && i < MAX_READERS; ++i) {
+        uint64_t epoch = readerEpochs[i].load();
+        if (epoch < oldest) oldest = epoch;
+    }
+
+    size_t kept = 0;
+    for (const auto& entry : retired) {
+        if (entry.version <= oldest) {
+            delete entry.snapshot;
+        } else {
+            retired[kept++] = entry;
+        }
+    }
+    retired.resize(kept);
+}
\ No newline at end of file
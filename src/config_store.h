@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "config.h"
+
+// Immutable AppConfig snapshots published with an atomic pointer swap.
+// Readers never lock: they load Current() and use it until their next
+// quiescent point. Replaced snapshots are retired and freed once every
+// registered reader has called Quiesce() after the swap (quiescent-state
+// based reclamation), so a reader can never see a freed snapshot.
+class ConfigStore {
+public:
+    using ReaderId = int;
+    static constexpr int MAX_READERS = 8;
+
+    explicit ConfigStore(const AppConfig& initial);
+    ~ConfigStore();
+
+    ConfigStore(const ConfigStore&) = delete;
+    ConfigStore& operator=(const ConfigStore&) = delete;
+
+    // Reader side (lock-free)
+    const AppConfig& Current() const { return *current.load(std::memory_order_acquire); }
+    uint64_t GetVersion() const { return version.load(std::memory_order_acquire); }
+    ReaderId RegisterReader();
+    void Quiesce(ReaderId reader);  // Caller holds no snapshot references
+
+    // Writer side; writers are serialized among themselves
+    void Publish(std::unique_ptr<const AppConfig> snapshot);
+    size_t GetRetiredCount() const;
+
+private:
+    struct Retired {
+        uint64_t version;  // version that replaced it
+        const AppConfig* snapshot;
+    };
+
+    void Reclaim();
+
+    std::atomic<const AppConfig*> current;
+    std::atomic<uint64_t> version{1};
+    // Last version each reader observed at a quiescent point; UINT64_MAX when unused
+    std::atomic<uint64_t> readerEpochs[MAX_READERS];
+    std::atomic<int> readerCount{0};
+
+    mutable std::mutex writerMutex;
+    std::vector<Retired> retired;
+};
\ No newline at end of file
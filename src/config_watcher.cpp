@@ -0,0 +1,125 @@
+#include "config_watcher.h"
+#include "logger.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+    #include <cerrno>
+    #include <cstring>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+    // Long enough to coalesce an editor's write + rename + chmod burst
+    constexpr std::chrono::milliseconds DEBOUNCE{100};
+    constexpr std::chrono::milliseconds POLL_INTERVAL{2000};
+
+    bool ReadFile(const std::string& path, std::string& content) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) return false;
+        std::ostringstream buffer;
+        buffer << file.rdbuf();
+        content = buffer.str();
+        return true;
+    }
+
+    std::chrono::system_clock::time_point GetModifiedTime(const std::string& path) {
+        std::error_code error;
+        auto time = std::filesystem::last_write_time(path, error);
+        if (error) return {};
+        // file_clock has no portable conversion in C++17; only equality matters here
+        return std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(time.time_since_epoch()));
+    }
+}
+
+ConfigWatcher::ConfigWatcher(EventLoop& loop, const std::string& path, ChangeCallback callback)
+    : loop(loop)
+    , path(path)
+    , callback(std::move(callback)) {
+    std::filesystem::path filePath(path);
+    directory = filePath.has_parent_path() ? filePath.parent_path().string() : ".";
+    fileName = filePath.filename().string();
+}
+
+ConfigWatcher::~ConfigWatcher() {
+    Stop();
+}
+
+bool ConfigWatcher::Start() {
+    ReadFile(path, lastContent);
+    lastModified = GetModifiedTime(path);
+    debounceTimer = loop.CreateTimer([this] { Check(); });
+
+#ifdef __linux__
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd >= 0 &&
+        inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) >= 0 &&
+        loop.WatchFd(inotifyFd, EventLoop::Readable, [this] { OnEvents(); })) {
+        return true;
+    }
+    LOG_WARNING("Cannot watch {} for config changes: {}, polling instead", directory, std::strerror(errno));
+    if (inotifyFd >= 0) {
+        close(inotifyFd);
+        inotifyFd = -1;
+    }
+#endif
+
+    loop.ArmTimer(debounceTimer, POLL_INTERVAL);
+    return true;
+}
+
+void ConfigWatcher::Stop() {
+#ifdef __linux__
+    if (inotifyFd >= 0) {
+        loop.UnwatchFd(inotifyFd);
+        close(inotifyFd);
+        inotifyFd = -1;
+    }
+#endif
+    if (debounceTimer >= 0) {
+        loop.DisarmTimer(debounceTimer);
+    }
+}
+
+void ConfigWatcher::OnEvents() {
+#ifdef __linux__
+    alignas(inotify_event) char buffer[4096];
+    bool relevant = false;
+
+    while (true) {
+        ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) break;
+
+        for (char* cursor = buffer; cursor < buffer + length;) {
+            auto* event = reinterpret_cast<inotify_event*>(cursor);
+            if (event->len > 0 && fileName == event->name) {
+                relevant = true;
+            }
+            cursor += sizeof(inotify_event) + event->len;
+        }
+    }
+
+    if (relevant) {
+        loop.ArmTimer(debounceTimer, DEBOUNCE);
+    }
+#endif
+}
+
+void ConfigWatcher::Check() {
+    if (inotifyFd < 0) {
+        loop.ArmTimer(debounceTimer, POLL_INTERVAL);
+        auto modified = GetModifiedTime(path);
+        if (modified == lastModified) return;
+        lastModified = modified;
+    }
+
+    std::string content;
+    if (!ReadFile(path, content) || content == lastContent) {
+        return;
+    }
+    lastContent = content;
+    callback(content);
+}
\ No newline at end of file
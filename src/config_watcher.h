@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include "event_loop.h"
+
+// Watches the config file for edits and calls back on the loop thread. On
+// Linux this is an inotify watch on the containing directory (editors often
+// replace the file by rename); elsewhere the file's mtime is polled. Bursts
+// of events are coalesced and unchanged content is ignored.
+class ConfigWatcher {
+public:
+    using ChangeCallback = std::function<void(const std::string& content)>;
+
+    ConfigWatcher(EventLoop& loop, const std::string& path, ChangeCallback callback);
+    ~ConfigWatcher();
+
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    bool Start();
+    void Stop();
+
+private:
+    void OnEvents();
+    void Check();
+
+    EventLoop& loop;
+    std::string path;
+    std::string directory;
+    std::string fileName;
+    ChangeCallback callback;
+
+    EventLoop::TimerId debounceTimer = -1;
+    int inotifyFd = -1;
+    std::string lastContent;
+    std::chrono::system_clock::time_point lastModified;
+};
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "cpu_governor.h"
+#include "logger.h"
+#include "resource_usage.h"
+
+CpuGovernor::CpuGovernor()
+    : windowStart(std::chrono::steady_clock::now())
+    , windowCpuStart(GetProcessCpuTime()) {
+}
+
+void CpuGovernor::SetBudget(double percentOfCore) {
+    budgetPercent = percentOfCore > 0.0 ? percentOfCore : 0.0;
+    if (budgetPercent == 0.0 && level != Level::Full) {
+        level = Level::Full;
+        LOG_INFO("CPU budget disabled, back to {} detection", GetLevelName(level));
+    }
+}
+
+void CpuGovernor::BeginCycle() {
+    cycleStart = GetThreadCpuTime();
+}
+
+void CpuGovernor::EndCycle() {
+    auto cost = GetThreadCpuTime() - cycleStart;
+    cycleTotal += cost;
+    if (cost > cycleMax) cycleMax = cost;
+    ++cycles;
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - windowStart >= WINDOW) {
+        Evaluate(now);
+    }
+}
+
+void CpuGovernor::Evaluate(std::chrono::steady_clock::time_point now) {
+    auto cpu = GetProcessCpuTime();
+    double wallNs = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - windowStart).count());
+    usagePercent = 100.0 * static_cast<double>((cpu - windowCpuStart).count()) / wallNs;
+    windowStart = now;
+    windowCpuStart = cpu;
+    if (budgetPercent == 0.0) return;
+
+    // Step one level at a time; recovering needs real headroom so a cycle
+    // cost right at the budget does not flap between two levels
+    if (usagePercent > budgetPercent && level != Level::Minimal) {
+        level = static_cast<Level>(static_cast<uint8_t>(level) + 1);
+        LOG_INFO("Using {}% of a core (budget {}%), degrading to {} detection", usagePercent, budgetPercent,
+                 GetLevelName(level));
+    } else if (usagePercent < budgetPercent / 2 && level != Level::Full) {
+        level = static_cast<Level>(static_cast<uint8_t>(level) - 1);
+        LOG_INFO("Using {}% of a core (budget {}%), recovering to {} detection", usagePercent, budgetPercent,
+                 GetLevelName(level));
+    }
+}
+
+std::chrono::milliseconds CpuGovernor::Stretch(std::chrono::milliseconds interval) const {
+    return level >= Level::Slow ? interval * 4 : interval;
+}
+
+CpuGovernor::Report CpuGovernor::GetReport() const {
+    Report report;
+    report.usagePercent = usagePercent;
+    report.budgetPercent = budgetPercent;
+    report.cycles = cycles;
+    if (cycles > 0) {
+        report.cycleAverage = std::chrono::duration_cast<std::chrono::microseconds>(cycleTotal / cycles);
+    }
+    report.cycleMax = std::chrono::duration_cast<std::chrono::microseconds>(cycleMax);
+    report.level = level;
+    return report;
+}
+
+const char* CpuGovernor::GetLevelName(Level level) {
+    switch (level) {
+        case Level::Full: return "full";
+        case Level::Lean: return "lean";
+        case Level::Slow: return "slow";
+        case Level::Minimal: return "minimal";
+    }
+    return "unknown";
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Keeps the daemon's own CPU use under a budget, since it shares the machine
+// with a real-time audio application. Each detection cycle is timed on the
+// loop thread, and the whole process's CPU (helper commands included) is
+// compared with wall time over a window. Over budget it degrades one level
+// per window, and recovers one level per window once well under budget.
+class CpuGovernor {
+public:
+    enum class Level : uint8_t {
+        Full,       // Everything
+        Lean,       // No optional enrichment (Wine registry reads)
+        Slow,       // Lean, at a quarter of the update rate
+        Minimal     // Slow, and only the tracked PID is checked between scans
+    };
+
+    struct Report {
+        double usagePercent = 0.0;      // Last window, percent of one core
+        double budgetPercent = 0.0;     // 0 when not enforced
+        uint64_t cycles = 0;
+        std::chrono::microseconds cycleAverage{0};
+        std::chrono::microseconds cycleMax{0};
+        Level level = Level::Full;
+    };
+
+    CpuGovernor();
+
+    // Percent of one core; 0 measures but never degrades
+    void SetBudget(double percentOfCore);
+
+    // Bracket one detection cycle on the loop thread
+    void BeginCycle();
+    void EndCycle();
+
+    Level GetLevel() const { return level; }
+    std::chrono::milliseconds Stretch(std::chrono::milliseconds interval) const;
+    Report GetReport() const;
+
+    static const char* GetLevelName(Level level);
+
+private:
+    void Evaluate(std::chrono::steady_clock::time_point now);
+
+    static constexpr std::chrono::seconds WINDOW{10};
+
+    double budgetPercent = 0.0;
+    Level level = Level::Full;
+
+    // Current window
+    std::chrono::steady_clock::time_point windowStart;
+    std::chrono::nanoseconds windowCpuStart{0};
+    double usagePercent = 0.0;
+
+    // Per-cycle cost on the loop thread
+    std::chrono::nanoseconds cycleStart{0};
+    std::chrono::nanoseconds cycleTotal{0};
+    std::chrono::nanoseconds cycleMax{0};
+    uint64_t cycles = 0;
+};
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include "detector_recording.h"
+#include "logger.h"
+#include <chrono>
+#include <cstring>
+#include <iterator>
+
+namespace {
+    const char MAGIC[8] = {'F', 'L', 'R', 'P', 'C', 'R', 'E', 'C'};
+    const uint8_t VERSION = 1;
+
+    enum CycleKind : uint8_t {
+        Candidates = 0,
+        Unchanged = 1
+    };
+
+    enum ProcessFlags : uint8_t {
+        Visible = 1 << 0
+    };
+
+    int64_t NowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool SameCandidates(const std::vector<ProcessInfo>& a, const std::vector<ProcessInfo>& b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (a[i].pid != b[i].pid || a[i].isVisible != b[i].isVisible || a[i].name != b[i].name ||
+                a[i].executablePath != b[i].executablePath || a[i].windowTitle != b[i].windowTitle) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Bounds-checked reader over the loaded file
+    struct Reader {
+        const std::string& data;
+        size_t offset = 0;
+        bool failed = false;
+
+        uint8_t Byte() {
+            if (offset >= data.size()) {
+                failed = true;
+                return 0;
+            }
+            return static_cast<uint8_t>(data[offset++]);
+        }
+
+        uint64_t Varint() {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                uint8_t byte = Byte();
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) return value;
+            }
+            failed = true;
+            return 0;
+        }
+
+        std::string String() {
+            uint64_t length = Varint();
+            if (failed || length > data.size() - offset) {
+                failed = true;
+                return std::string();
+            }
+            std::string value = data.substr(offset, length);
+            offset += length;
+            return value;
+        }
+    };
+}
+
+// Recorder
+bool DetectorRecorder::Open(const std::string& path) {
+    Close();
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        LOG_ERROR("Cannot open recording file {}", path);
+        return false;
+    }
+
+    file.write(MAGIC, sizeof(MAGIC));
+    file.put(static_cast<char>(VERSION));
+    file.flush();
+
+    startMs = lastMs = NowMs();
+    hasPrevious = false;
+    cycleCount = 0;
+    LOG_INFO("Recording detector input to {}", path);
+    return true;
+}
+
+void DetectorRecorder::Close() {
+    if (file.is_open()) {
+        file.close();
+        LOG_INFO("Recorded {} detection cycles", cycleCount);
+    }
+}
+
+void DetectorRecorder::RecordCycle(const std::vector<ProcessInfo>& candidates) {
+    if (!file.is_open()) return;
+
+    int64_t now = NowMs();
+    pending.clear();
+    WriteVarint(static_cast<uint64_t>(now - lastMs));
+    lastMs = now;
+
+    if (hasPrevious && SameCandidates(candidates, previous)) {
+        pending += static_cast<char>(Unchanged);
+    } else {
+        pending += static_cast<char>(Candidates);
+        WriteVarint(candidates.size());
+        for (const auto& process : candidates) {
+            WriteVarint(static_cast<uint32_t>(process.pid));
+            pending += static_cast<char>(process.isVisible ? Visible : 0);
+            WriteString(process.name);
+            WriteString(process.executablePath);
+            WriteString(process.windowTitle);
+        }
+        previous = candidates;
+        hasPrevious = true;
+    }
+
+    // One write and flush per cycle keeps the file usable if we crash
+    file.write(pending.data(), static_cast<std::streamsize>(pending.size()));
+    file.flush();
+    ++cycleCount;
+}
+
+void DetectorRecorder::WriteVarint(uint64_t value) {
+    while (value >= 0x80) {
+        pending += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    pending += static_cast<char>(value);
+}
+
+void DetectorRecorder::WriteString(const std::string& value) {
+    WriteVarint(value.size());
+    pending += value;
+}
+
+// Replay
+bool DetectorReplay::Load(const std::string& path, std::string& error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (data.size() < sizeof(MAGIC) + 1 || std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        error = path + " is not a detector recording";
+        return false;
+    }
+    if (static_cast<uint8_t>(data[sizeof(MAGIC)]) != VERSION) {
+        error = path + " has unsupported recording version " + std::to_string(static_cast<uint8_t>(data[sizeof(MAGIC)]));
+        return false;
+    }
+
+    snapshots.clear();
+    cycles.clear();
+    position = 0;
+
+    Reader reader{data, sizeof(MAGIC) + 1};
+    int64_t timeMs = 0;
+    while (reader.offset < data.size()) {
+        size_t cycleStart = reader.offset;
+        timeMs += static_cast<int64_t>(reader.Varint());
+        uint8_t kind = reader.Byte();
+
+        if (kind == Unchanged && !snapshots.empty()) {
+            if (!reader.failed) {
+                cycles.push_back({timeMs, snapshots.size() - 1});
+            }
+        } else if (kind == Candidates) {
+            std::vector<ProcessInfo> candidates;
+            uint64_t count = reader.Varint();
+            for (uint64_t i = 0; i < count && !reader.failed; ++i) {
+                ProcessInfo process;
+                process.pid = static_cast<int>(reader.Varint());
+                process.isVisible = (reader.Byte() & Visible) != 0;
+                process.name = reader.String();
+                process.executablePath = reader.String();
+                process.windowTitle = reader.String();
+                candidates.push_back(std::move(process));
+            }
+            if (!reader.failed) {
+                snapshots.push_back(std::move(candidates));
+                cycles.push_back({timeMs, snapshots.size() - 1});
+            }
+        } else {
+            reader.failed = true;
+        }
+
+        // A truncated final cycle (recording interrupted) is dropped
+        if (reader.failed) {
+            if (cycles.empty()) {
+                error = path + " is corrupt at byte " + std::to_string(cycleStart);
+                return false;
+            }
+            LOG_WARNING("Ignoring damaged recording tail at byte {}", cycleStart);
+            break;
+        }
+    }
+
+    return true;
+}
+
+const std::vector<ProcessInfo>& DetectorReplay::Current() const {
+    static const std::vector<ProcessInfo> none;
+    return AtEnd() ? none : snapshots[cycles[position].snapshot];
+}
+
+int64_t DetectorReplay::GetCurrentTimeMs() const {
+    return AtEnd() ? GetDurationMs() : cycles[position].timeMs;
+}
+
+int64_t DetectorReplay::GetDelayToNextMs() const {
+    if (position + 1 >= cycles.size()) return 0;
+    return cycles[position + 1].timeMs - cycles[position].timeMs;
+}
\ No newline at end of file
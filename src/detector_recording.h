@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../include/fl_studio_types.h"
+
+// Binary trace of what FLStudioDetector saw each cycle: the FL Studio
+// candidate processes with their window titles, stamped with milliseconds
+// since recording started. Cycles identical to the previous one are stored
+// as a single marker, so idle hours cost a few bytes per cycle.
+//
+// Layout: "FLRPCREC" version:u8, then per cycle
+//   deltaMs:varint kind:u8 (0 = candidates follow, 1 = unchanged)
+//   [count:varint, per candidate: pid:varint flags:u8 name path title]
+// where strings are length:varint followed by the bytes.
+class DetectorRecorder {
+public:
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return file.is_open(); }
+
+    // Called by the detector once per scan, after titles are fetched
+    void RecordCycle(const std::vector<ProcessInfo>& candidates);
+
+    uint64_t GetCycleCount() const { return cycleCount; }
+
+private:
+    void WriteVarint(uint64_t value);
+    void WriteString(const std::string& value);
+
+    std::ofstream file;
+    std::string pending;
+    std::vector<ProcessInfo> previous;
+    bool hasPrevious = false;
+    int64_t startMs = 0;
+    int64_t lastMs = 0;
+    uint64_t cycleCount = 0;
+};
+
+// Loads a recording and hands its cycles back one at a time, in order
+class DetectorReplay {
+public:
+    bool Load(const std::string& path, std::string& error);
+
+    bool AtEnd() const { return position >= cycles.size(); }
+    void Advance() { ++position; }
+
+    // Candidates of the current cycle (empty once past the end)
+    const std::vector<ProcessInfo>& Current() const;
+    // Recorded time of the current cycle, milliseconds since recording started
+    int64_t GetCurrentTimeMs() const;
+    // Recorded time between the current cycle and the next one
+    int64_t GetDelayToNextMs() const;
+
+    size_t GetCycleCount() const { return cycles.size(); }
+    size_t GetPosition() const { return position; }
+    int64_t GetDurationMs() const { return cycles.empty() ? 0 : cycles.back().timeMs; }
+
+private:
+    struct Cycle {
+        int64_t timeMs;
+        size_t snapshot;  // Index into snapshots; unchanged cycles share one
+    };
+
+    std::vector<std::vector<ProcessInfo>> snapshots;
+    std::vector<Cycle> cycles;
+    size_t position = 0;
+};
\ No newline at end of file
@@ -1,135 +1,506 @@
-// discord_client.cpp - Simple Discord RPC approach
+// discord_client.cpp - Discord local RPC (IPC) client
 #include "discord_client.h"
 #include "fl_studio_detector.h"
-#include <iostream>
+#include "discord_ipc.h"
+#include "activity_serializer.h"
+#include "event_loop.h"
+#include "discord_sdk.h"
+#include "resource_usage.h"
+#include "recording_watcher.h"
+#include "presence_bus.h"
+#include "presence_sinks.h"
+#include "websocket_sink.h"
+#include "state_export.h"
+#include "session_snapshot.h"
+#include "process_detector.h"
+#include "config.h"
+#include "privacy_matcher.h"
+#include "config_store.h"
+#include "config_watcher.h"
+#include "detector_recording.h"
+#include "logger.h"
+#include "trace.h"
 #include <thread>
 #include <chrono>
 #include <ctime>
+#include <random>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <map>
+#include <csignal>
+#include <cstdio>
+#include <sstream>
 
-// For now, let's implement a simple mock that works without the complex Partner SDK
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <unistd.h>
+#endif
+
+namespace {
+    constexpr std::chrono::milliseconds INITIAL_BACKOFF{250};
+    constexpr std::chrono::milliseconds MAX_BACKOFF{2000};
+    constexpr std::chrono::milliseconds CONNECT_TIMEOUT{2000};
+    constexpr std::chrono::milliseconds HANDSHAKE_TIMEOUT{5000};
+    constexpr std::chrono::milliseconds READY_POLL_INTERVAL{500};
+    constexpr std::chrono::milliseconds PENDING_POLL_INTERVAL{50};
+    constexpr std::chrono::minutes OVERHEAD_REPORT_INTERVAL{10};
+    constexpr std::chrono::seconds SNAPSHOT_INTERVAL{30};
+    constexpr std::chrono::seconds RECORDING_LOOKUP_INTERVAL{10};
+    
+    const char* StateName(DiscordClient::ConnectionState state) {
+        switch (state) {
+            case DiscordClient::ConnectionState::Disconnected: return "disconnected";
+            case DiscordClient::ConnectionState::Connecting: return "connecting";
+            case DiscordClient::ConnectionState::Handshaking: return "handshaking";
+            case DiscordClient::ConnectionState::Ready: return "ready";
+        }
+        return "unknown";
+    }
+    
+    // Clears custom messages that do not compile and drops hidden-project
+    // rules that do not parse, reporting each
+    void ResetInvalidPresenceRules(AppConfig& config, std::string& errors) {
+        std::string* messages[] = {
+            &config.customIdleMessage, &config.customComposingMessage,
+            &config.customPlayingMessage, &config.customRecordingMessage
+        };
+        for (auto* message : messages) {
+            PresenceTemplate compiled;
+            std::string error;
+            if (message->empty() || PresenceTemplate::Compile(*message, compiled, error)) continue;
+            errors += "custom message '" + *message + "': " + error + "\n";
+            message->clear();
+        }
+        
+        std::vector<std::string> rules;
+        for (auto& rule : config.hiddenProjects) {
+            PrivacyMatcher matcher;
+            if (matcher.Compile({rule}, errors)) {
+                rules.push_back(std::move(rule));
+            }
+        }
+        config.hiddenProjects = std::move(rules);
+    }
+    
+    int GetCurrentPid() {
+#ifdef _WIN32
+        return static_cast<int>(GetCurrentProcessId());
+#else
+        return static_cast<int>(getpid());
+#endif
+    }
+    
+    // Runs before anything downstream sees project names or paths
+    void ScrubHiddenProjects(const PrivacyMatcher& privacy, FLStudioInfo& info) {
+        if (privacy.IsHidden(info.projectName, info.projectPath)) {
+            info.projectName.clear();
+            info.projectPath.clear();
+            info.windowTitle.clear();
+        }
+        auto& recent = info.recentProjects;
+        recent.erase(std::remove_if(recent.begin(), recent.end(), [&](const std::string& path) {
+            size_t nameStart = path.find_last_of('/') + 1;
+            return privacy.IsHidden(path.substr(nameStart, path.size() - nameStart - 4), path);
+        }), recent.end());
+    }
+    
+    // Discord as a presence sink. Delivered inline on the loop thread: the
+    // client never blocks, writes go out through the event loop.
+    class DiscordSink : public PresenceSink {
+    public:
+        explicit DiscordSink(DiscordClient& client) : client(client) {}
+        
+        const char* GetName() const override { return "discord"; }
+        
+        void Deliver(const PresenceEvent& event) override {
+            if (!event.presence.active) {
+                client.ClearPresence();
+                return;
+            }
+            client.UpdateRichPresence(event.presence, [](bool success, const std::string& error) {
+                if (!success) {
+                    LOG_ERROR("Failed to update Discord presence: {}", error);
+                }
+            });
+        }
+        
+    private:
+        DiscordClient& client;
+    };
+}
+
+// Discord local RPC client: disconnected -> connecting -> handshaking -> ready.
+// Reconnects use jittered exponential backoff and never block the caller.
 class DiscordClient::Impl {
 public:
+    using Clock = std::chrono::steady_clock;
+    using State = DiscordClient::ConnectionState;
+    
     std::string applicationId;
     bool initialized = false;
-    bool connected = false;
-    bool isReady = false;
+    State state = State::Disconnected;
     
-    // Simple state tracking
-    FLStudioInfo lastInfo;
-    std::chrono::steady_clock::time_point startTime;
+    DiscordIpcTransport transport;
+    JsonWriter json;          // reused for every outgoing payload
+    std::string incoming;     // reused for every incoming frame
+    Clock::time_point stateSince;
+    Clock::time_point nextAttempt;
+    int failedAttempts = 0;
+    bool reportedUnavailable = false;
+    std::mt19937 rng;
+    uint64_t nonce = 0;
+    
+    // Latest presence, replayed as soon as a (re)connection becomes ready
+    RenderedPresence latestPresence;
+    bool hasLatestPresence = false;
+    
+    // Optional SDK, only loaded when configured
+    DiscordSdk sdk;
+    std::string sdkLocation;
     
-    explicit Impl(const std::string& appId) : applicationId(appId) {
-        startTime = std::chrono::steady_clock::now();
+    // Reactor integration: the socket and a deadline timer drive RunCallbacks()
+    EventLoop* loop = nullptr;
+    EventLoop::TimerId timer = -1;
+    int watchedFd = -1;
+    
+    explicit Impl(const std::string& appId)
+        : applicationId(appId)
+        , rng(std::random_device{}()) {
+        stateSince = Clock::now();
+        nextAttempt = stateSince;
     }
     
     bool Initialize() {
-        std::cout << "Initializing Simple Discord RPC with App ID: " << applicationId << std::endl;
+        LOG_INFO("Initializing Discord RPC with App ID: {}", applicationId);
         
-        // For now, simulate successful initialization
-        // TODO: Implement actual Discord RPC connection
         initialized = true;
-        connected = true;
-        isReady = true;
-        
-        std::cout << "Discord RPC simulated successfully (Partner SDK requires full OAuth)" << std::endl;
-        std::cout << "Note: For actual Discord integration, you'll need to:" << std::endl;
-        std::cout << "1. Set up OAuth2 in your Discord app" << std::endl;
-        std::cout << "2. Add redirect URI: http://127.0.0.1/callback" << std::endl;
-        std::cout << "3. Use proper authentication flow" << std::endl;
+        state = State::Disconnected;
+        nextAttempt = Clock::now();
+        failedAttempts = 0;
         
+        // Kick off the first connection attempt; if Discord is not up yet
+        // we keep retrying in the background from RunCallbacks()
+        RunCallbacks();
         return true;
     }
     
-    void UpdateActivity(const FLStudioInfo& info, DiscordClient::UpdateCallback callback) {
+    void UpdateActivity(const RenderedPresence& presence, DiscordClient::UpdateCallback callback) {
         if (!initialized) {
             if (callback) callback(false, "Discord not initialized");
             return;
         }
         
-        // Log what we would send to Discord
-        std::string details = BuildDetails(info);
-        std::string state = BuildState(info);
+        latestPresence = presence;
+        hasLatestPresence = true;
         
-        auto now = std::chrono::steady_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::seconds>(now - startTime).count();
-        
-        std::cout << "\n--- Discord Rich Presence Update ---" << std::endl;
-        std::cout << "Details: " << details << std::endl;
-        std::cout << "State: " << state << std::endl;
-        std::cout << "Large Image: fl_studio_logo" << std::endl;
-        
-        if (info.isRecording) {
-            std::cout << "Small Image: recording (Recording)" << std::endl;
-        } else if (info.isPlaying) {
-            std::cout << "Small Image: playing (Playing)" << std::endl;
-        } else if (!info.projectName.empty()) {
-            std::cout << "Small Image: composing (Composing)" << std::endl;
-        } else {
-            std::cout << "Small Image: idle (Idle)" << std::endl;
+        if (state != State::Ready) {
+            if (callback) {
+                callback(false, std::string("Discord is ") + StateName(state) + ", presence will be sent once connected");
+            }
+            return;
         }
         
-        std::cout << "Session Duration: " << duration << " seconds" << std::endl;
-        std::cout << "-----------------------------------\n" << std::endl;
-        
-        lastInfo = info;
-        
-        if (callback) {
-            callback(true, "Simulated update successful");
+        if (SendActivity(presence)) {
+            if (callback) callback(true, "");
+        } else {
+            HandleDisconnect("write failed");
+            if (callback) callback(false, "Lost connection to Discord");
         }
     }
     
     void ClearActivity() {
-        if (!initialized) return;
+        hasLatestPresence = false;
+        if (!initialized || state != State::Ready) return;
         
-        std::cout << "Discord presence cleared (simulated)" << std::endl;
+        RenderedPresence cleared;
+        WriteSetActivity(json, GetCurrentPid(), cleared, ++nonce);
+        if (transport.SendFrame(DiscordIpcTransport::Opcode::Frame, json.View())) {
+            LOG_INFO("Discord presence cleared");
+        }
     }
     
     void Shutdown() {
         if (initialized) {
             ClearActivity();
+            UnwatchSocket();
+            if (loop) loop->DisarmTimer(timer);
+            transport.Close();
             initialized = false;
-            connected = false;
-            isReady = false;
-            std::cout << "Discord RPC shut down (simulated)" << std::endl;
+            state = State::Disconnected;
+            LOG_INFO("Discord RPC shut down");
         }
     }
     
     void RunCallbacks() {
-        // In a real implementation, this would process Discord SDK callbacks
-        // For now, just a no-op
+        if (!initialized) return;
+        
+        if (!sdkLocation.empty()) {
+            LoadSdk();
+            sdk.RunCallbacks();
+        }
+        
+        auto now = Clock::now();
+        switch (state) {
+            case State::Disconnected:
+                if (now >= nextAttempt) {
+                    BeginConnect(now);
+                }
+                break;
+                
+            case State::Connecting: {
+                auto result = transport.FinishConnect();
+                if (result == DiscordIpcTransport::IoResult::Ok) {
+                    BeginHandshake(now);
+                } else if (result != DiscordIpcTransport::IoResult::WouldBlock ||
+                           now - stateSince > CONNECT_TIMEOUT) {
+                    HandleDisconnect("connect failed");
+                }
+                break;
+            }
+                
+            case State::Handshaking:
+            case State::Ready:
+                ProcessIncoming(now);
+                if (state == State::Handshaking && now - stateSince > HANDSHAKE_TIMEOUT) {
+                    HandleDisconnect("handshake timed out");
+                }
+                break;
+        }
+        
+        SyncLoop();
+    }
+    
+    void SetApplicationId(const std::string& appId) {
+        if (appId == applicationId) return;
+        applicationId = appId;
+        
+        // The client ID is part of the handshake: reconnect under the new one
+        if (initialized && state != State::Disconnected) {
+            LOG_INFO("Discord application ID changed, reconnecting");
+            HandleDisconnect("application ID changed");
+        }
+    }
+    
+    void AttachToLoop(EventLoop& eventLoop) {
+        loop = &eventLoop;
+        timer = loop->CreateTimer([this] { RunCallbacks(); });
+        SyncLoop();
+    }
+    
+    void DetachFromLoop() {
+        if (!loop) return;
+        UnwatchSocket();
+        loop->DestroyTimer(timer);
+        timer = -1;
+        loop = nullptr;
+    }
+    
+    std::chrono::milliseconds GetTimeUntilNextAction() const {
+        if (!initialized) {
+            return MAX_BACKOFF;
+        }
+        switch (state) {
+            case State::Disconnected: {
+                auto remaining = std::chrono::ceil<std::chrono::milliseconds>(nextAttempt - Clock::now());
+                return remaining.count() > 0 ? remaining : std::chrono::milliseconds(0);
+            }
+            case State::Connecting:
+            case State::Handshaking:
+                return PENDING_POLL_INTERVAL;
+            case State::Ready:
+                return READY_POLL_INTERVAL;
+        }
+        return READY_POLL_INTERVAL;
     }
     
 private:
-    std::string BuildDetails(const FLStudioInfo& info) {
-        if (!info.isRunning) {
-            return "FL Studio";
+    void LoadSdk() {
+        if (sdk.IsLoaded()) return;
+        
+        auto started = Clock::now();
+        size_t rssBefore = GetResidentSetBytes();
+        std::string error;
+        bool loaded = sdk.EnsureLoaded(sdkLocation, error);
+        if (!loaded) {
+            LOG_WARNING("Discord SDK not loaded, continuing over IPC only:");
+            LOG_WARNING_LINES(error);
+            sdkLocation.clear();
+            return;
         }
         
-        if (!info.projectName.empty()) {
-            return "Working on " + info.projectName;
+        auto elapsed = std::chrono::duration<double, std::milli>(Clock::now() - started).count();
+        char before[32], after[32];
+        LOG_INFO("Loaded Discord SDK from {} in {} ms (RSS {} -> {})", sdk.GetLoadedPath(), elapsed,
+                 FormatBytes(rssBefore, before, sizeof(before)),
+                 FormatBytes(GetResidentSetBytes(), after, sizeof(after)));
+    }
+    
+    // Watches the socket (writable while connecting, readable after) and arms
+    // the timer for the next deadline. Without a watchable socket the timer
+    // falls back to the polling cadence of GetTimeUntilNextAction().
+    void SyncLoop() {
+        if (!loop || !initialized) return;
+        
+        uint32_t events = state == State::Connecting ? EventLoop::Writable : EventLoop::Readable;
+        int fd = transport.GetPollFd();
+        if (watchedFd >= 0) {
+            loop->ModifyFd(watchedFd, events);
+        } else if (fd >= 0 && loop->WatchFd(fd, events, [this] { RunCallbacks(); })) {
+            watchedFd = fd;
         }
         
-        if (info.isRecording) {
-            return "Recording";
-        } else if (info.isPlaying) {
-            return "Playing music";
-        } else {
-            return "Composing music";
+        if (watchedFd < 0) {
+            loop->ArmTimer(timer, GetTimeUntilNextAction());
+            return;
+        }
+        
+        std::chrono::milliseconds timeout;
+        switch (state) {
+            case State::Connecting: timeout = CONNECT_TIMEOUT; break;
+            case State::Handshaking: timeout = HANDSHAKE_TIMEOUT; break;
+            default:
+                // A loaded SDK needs its callbacks pumped even when the socket is quiet
+                if (sdk.IsLoaded()) {
+                    loop->ArmTimer(timer, READY_POLL_INTERVAL);
+                } else {
+                    loop->DisarmTimer(timer);
+                }
+                return;
         }
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(stateSince + timeout - Clock::now());
+        loop->ArmTimer(timer, remaining + std::chrono::milliseconds(1));
     }
     
-    std::string BuildState(const FLStudioInfo& info) {
-        std::string state = info.version;
+    void UnwatchSocket() {
+        if (loop && watchedFd >= 0) {
+            loop->UnwatchFd(watchedFd);
+        }
+        watchedFd = -1;
+    }
+    
+    void SetState(State newState, Clock::time_point now) {
+        state = newState;
+        stateSince = now;
+    }
+    
+    void BeginConnect(Clock::time_point now) {
+        SetState(State::Connecting, now);
         
-        if (info.bpm > 0) {
-            state += " • " + std::to_string(info.bpm) + " BPM";
+        auto result = transport.Connect();
+        if (result == DiscordIpcTransport::IoResult::Ok) {
+            BeginHandshake(now);
+        } else if (result != DiscordIpcTransport::IoResult::WouldBlock) {
+            HandleDisconnect("Discord IPC socket not found");
         }
+    }
+    
+    void BeginHandshake(Clock::time_point now) {
+        SetState(State::Handshaking, now);
+        
+        WriteHandshake(json, applicationId);
+        if (!transport.SendFrame(DiscordIpcTransport::Opcode::Handshake, json.View())) {
+            HandleDisconnect("handshake write failed");
+        }
+    }
+    
+    void ProcessIncoming(Clock::time_point now) {
+        DiscordIpcTransport::Opcode opcode;
+        std::string& payload = incoming;
         
-        if (info.hasUnsavedChanges) {
-            state += " • Unsaved";
+        while (true) {
+            auto result = transport.ReadFrame(opcode, payload);
+            if (result == DiscordIpcTransport::IoResult::WouldBlock) {
+                return;
+            }
+            if (result != DiscordIpcTransport::IoResult::Ok) {
+                HandleDisconnect("connection closed by Discord");
+                return;
+            }
+            
+            switch (opcode) {
+                case DiscordIpcTransport::Opcode::Ping:
+                    transport.SendFrame(DiscordIpcTransport::Opcode::Pong, payload);
+                    break;
+                    
+                case DiscordIpcTransport::Opcode::Close:
+                    HandleDisconnect("Discord closed the connection: " + payload);
+                    return;
+                    
+                case DiscordIpcTransport::Opcode::Frame:
+                    if (state == State::Handshaking && JsonFieldEquals(payload, "evt", "READY")) {
+                        OnReady(now);
+                    } else if (JsonFieldEquals(payload, "evt", "ERROR")) {
+                        LOG_ERROR("Discord RPC error: {}", payload);
+                    }
+                    break;
+                    
+                default:
+                    break;
+            }
         }
+    }
+    
+    void OnReady(Clock::time_point now) {
+        SetState(State::Ready, now);
+        failedAttempts = 0;
+        reportedUnavailable = false;
+        LOG_INFO("Connected to Discord via {}", transport.GetConnectedPath());
         
-        return state;
+        // Resync: replay the most recent presence right away
+        if (hasLatestPresence && !SendActivity(latestPresence)) {
+            HandleDisconnect("write failed");
+        }
+    }
+    
+    void HandleDisconnect(const std::string& reason) {
+        bool wasReady = state == State::Ready;
+        UnwatchSocket();
+        transport.Close();
+        
+        auto now = Clock::now();
+        SetState(State::Disconnected, now);
+        
+        auto delay = NextBackoff();
+        nextAttempt = now + delay;
+        
+        if (wasReady) {
+            LOG_WARNING("Disconnected from Discord ({}), reconnecting...", reason);
+            reportedUnavailable = true;
+        } else if (!reportedUnavailable) {
+            LOG_WARNING("Discord not available ({}), retrying in the background", reason);
+            reportedUnavailable = true;
+        }
+        
+        SyncLoop();
+    }
+    
+    // Full-jitter exponential backoff in [ceiling/2, ceiling], capped so a
+    // restarted Discord is picked up within a couple of seconds
+    std::chrono::milliseconds NextBackoff() {
+        int exponent = failedAttempts < 8 ? failedAttempts : 8;
+        auto ceiling = INITIAL_BACKOFF * (1 << exponent);
+        if (ceiling > MAX_BACKOFF) {
+            ceiling = MAX_BACKOFF;
+        }
+        ++failedAttempts;
+        
+        std::uniform_int_distribution<long long> jitter(ceiling.count() / 2, ceiling.count());
+        return std::chrono::milliseconds(jitter(rng));
+    }
+    
+    bool SendActivity(const RenderedPresence& presence) {
+        WriteSetActivity(json, GetCurrentPid(), presence, ++nonce);
+        
+        if (!transport.SendFrame(DiscordIpcTransport::Opcode::Frame, json.View())) {
+            return false;
+        }
+        
+        LOG_INFO("Presence updated: details=\"{}\" state=\"{}\" large={} small={} ({})",
+                 presence.details.View(), presence.state.View(),
+                 presence.largeImage, presence.smallImage, presence.smallText);
+        return true;
     }
 };
 
@@ -147,8 +518,8 @@ void DiscordClient::Shutdown() {
     pImpl->Shutdown();
 }
 
-void DiscordClient::UpdateRichPresence(const FLStudioInfo& info, UpdateCallback callback) {
-    pImpl->UpdateActivity(info, callback);
+void DiscordClient::UpdateRichPresence(const RenderedPresence& presence, UpdateCallback callback) {
+    pImpl->UpdateActivity(presence, callback);
 }
 
 void DiscordClient::ClearPresence() {
@@ -156,38 +527,147 @@ void DiscordClient::ClearPresence() {
 }
 
 bool DiscordClient::IsConnected() const {
-    return pImpl->connected;
+    return pImpl->state == ConnectionState::Ready;
 }
 
 bool DiscordClient::IsInitialized() const {
     return pImpl->initialized;
 }
 
+DiscordClient::ConnectionState DiscordClient::GetConnectionState() const {
+    return pImpl->state;
+}
+
+std::chrono::milliseconds DiscordClient::GetTimeUntilNextAction() const {
+    return pImpl->GetTimeUntilNextAction();
+}
+
 void DiscordClient::RunCallbacks() {
     pImpl->RunCallbacks();
 }
 
+void DiscordClient::AttachToLoop(EventLoop& loop) {
+    pImpl->AttachToLoop(loop);
+}
+
+void DiscordClient::DetachFromLoop() {
+    pImpl->DetachFromLoop();
+}
+
+void DiscordClient::SetRuntimeDirectory(const std::string& directory) {
+    pImpl->transport.SetRuntimeDirectory(directory);
+}
+
+void DiscordClient::SetSdkLocation(const std::string& location) {
+    pImpl->sdkLocation = location;
+}
+
+void DiscordClient::SetApplicationId(const std::string& applicationId) {
+    pImpl->SetApplicationId(applicationId);
+}
+
 // FLStudioDiscordApp implementation remains the same as before...
 class FLStudioDiscordApp::AppImpl {
 public:
     std::unique_ptr<DiscordClient> discord;
     std::unique_ptr<FLStudioDetector> detector;
     
+    // Everything runs on the thread that called Run(): detection on a timer,
+    // Discord I/O on socket readiness, shutdown on SIGINT/SIGTERM
+    EventLoop loop;
+    EventLoop::TimerId detectionTimer = -1;
     std::atomic<bool> running{false};
-    std::thread updateThread;
+    std::thread::id loopThread;
+    std::mutex stopMutex;
+    std::condition_variable stoppedCondition;
     
-    // Configuration
+    // Configuration: published snapshots, picked up at the start of a cycle
+    ConfigStore config;
+    ConfigStore::ReaderId configReader;
+    uint64_t appliedConfigVersion;
+    std::unique_ptr<ConfigWatcher> configWatcher;
     std::chrono::milliseconds updateInterval{3000};
-    bool showProjectName = true;
-    bool showBPM = true;
+    std::chrono::seconds presenceTimeout{30};
+    bool presenceEnabled = true;
+    PresenceRenderer renderer;
+    PrivacyMatcher privacy;
+    
+    // Each presence change is rendered once and fanned out: Discord inline,
+    // the optional outputs on bounded queues of their own
+    PresenceBus bus;
+    std::string overlayFile;
+    std::string activityLogFile;
+    int webSocketPort = 0;
+    std::vector<std::string> webSocketOrigins;
+    PresenceBus::SinkId overlaySink = 0;
+    PresenceBus::SinkId activityLogSink = 0;
+    PresenceBus::SinkId webSocketSink = 0;
+    
+    // Current state for local tools, in shared memory
+    SharedStateExport stateExport;
+    bool exportState = true;
+    bool stateExportFailed = false;
+    
+    // Own CPU use: per-cycle cost, budget enforcement, periodic report
+    CpuGovernor governor;
+    CpuGovernor::Level economyLevel = CpuGovernor::Level::Full;
+    std::chrono::steady_clock::time_point lastOverheadReport = std::chrono::steady_clock::now();
+    
+    // Recording detection from FL Studio's recorded-audio folder
+    std::unique_ptr<RecordingWatcher> recordingWatcher;
+    std::string recordingFolder;    // Configured override
+    int recordingPid = 0;           // Instance the watch was resolved for
+    std::chrono::steady_clock::time_point lastRecordingLookup;
+    
+    // Warm start: last session persisted across restarts
+    std::string snapshotPath;
+    std::chrono::steady_clock::time_point lastSnapshotSave;
+    SessionSnapshot savedSnapshot;
     
     // State tracking
+    StateDebouncer debouncer;
+    StateDebouncer::Holds debounceHolds;
     FLStudioInfo lastInfo;
+    RenderedPresence presence;  // Reused render target
     std::chrono::steady_clock::time_point lastUpdate;
+    bool forceUpdate = false;
+    bool presenceShown = false;
+    
+    // Record/replay of detector input
+    DetectorRecorder recorder;
+    std::unique_ptr<DetectorReplay> replay;
+    bool replayRealTime = false;
+    std::chrono::steady_clock::time_point replayStarted;
+    uint64_t replayUpdates = 0;
+    uint64_t replayDigest = 14695981039346656037ull;  // FNV-1a over rendered presences
+    
+    // Multi-user mode: one Discord connection per user running FL Studio
+    struct UserSession {
+        std::unique_ptr<DiscordClient> discord;
+        StateDebouncer debouncer;
+        FLStudioInfo lastInfo;
+        RenderedPresence presence;
+        std::chrono::steady_clock::time_point lastUpdate;
+        bool presenceShown = false;
+        bool active = false;
+    };
+    bool multiUser = false;
+    std::string applicationId;
+    std::map<int, UserSession> users;
     
     explicit AppImpl(const std::string& applicationId)
         : discord(std::make_unique<DiscordClient>(applicationId))
-        , detector(std::make_unique<FLStudioDetector>()) {
+        , detector(std::make_unique<FLStudioDetector>())
+        , config(DefaultConfig(applicationId))
+        , configReader(config.RegisterReader())
+        , appliedConfigVersion(config.GetVersion())
+        , applicationId(applicationId) {
+    }
+    
+    static AppConfig DefaultConfig(const std::string& applicationId) {
+        AppConfig defaults;
+        defaults.applicationId = applicationId;
+        return defaults;
     }
 };
 
@@ -200,138 +680,637 @@ FLStudioDiscordApp::~FLStudioDiscordApp() {
 }
 
 bool FLStudioDiscordApp::Initialize() {
-    std::cout << "Initializing FL Studio Discord Rich Presence..." << std::endl;
+    LOG_INFO("Initializing FL Studio Discord Rich Presence...");
     
-    if (!pImpl->discord->Initialize()) {
-        std::cerr << "Failed to initialize Discord client" << std::endl;
-        return false;
+    // In multi-user mode connections are per user and opened on demand
+    if (!pImpl->multiUser) {
+        pImpl->discord->AttachToLoop(pImpl->loop);
+        if (!pImpl->discord->Initialize()) {
+            LOG_ERROR("Failed to initialize Discord client");
+            return false;
+        }
+        PresenceBus::SinkOptions inlineDelivery;
+        inlineDelivery.inlineDelivery = true;
+        pImpl->bus.Subscribe(std::make_unique<DiscordSink>(*pImpl->discord), inlineDelivery);
     }
     
-    pImpl->detector->SetUpdateInterval(pImpl->updateInterval);
+    SetUpdateInterval(pImpl->updateInterval);
+    RestoreSnapshot();
+    pImpl->detectionTimer = pImpl->loop.CreateTimer([this] { RunDetectionCycle(); });
+    pImpl->recordingWatcher = std::make_unique<RecordingWatcher>(pImpl->loop, [this](bool) {
+        // Show the change now rather than at the next interval
+        if (pImpl->running.load()) {
+            pImpl->loop.ArmTimer(pImpl->detectionTimer, std::chrono::milliseconds(0));
+        }
+    });
     
-    std::cout << "FL Studio Discord Rich Presence initialized successfully" << std::endl;
+    LOG_INFO("FL Studio Discord Rich Presence initialized successfully");
     return true;
 }
 
 void FLStudioDiscordApp::Run() {
     if (pImpl->running.load()) {
-        std::cout << "Application is already running" << std::endl;
+        LOG_WARNING("Application is already running");
         return;
     }
     
+    pImpl->loopThread = std::this_thread::get_id();
     pImpl->running.store(true);
-    pImpl->updateThread = std::thread(&FLStudioDiscordApp::UpdateLoop, this);
     
-    std::cout << "FL Studio Discord Rich Presence is running..." << std::endl;
-    std::cout << "Monitoring for FL Studio processes..." << std::endl;
-    std::cout << "Open FL Studio to see rich presence updates below:" << std::endl;
+    auto onSignal = [this](int signal) {
+#ifndef _WIN32
+        if (signal == SIGUSR1) {
+            if (!Tracer::Dump()) {
+                LOG_WARNING("Tracing is off, set FLRPC_TRACE=<file> to record spans");
+            }
+            return;
+        }
+#endif
+        LOG_INFO("Received signal {}, shutting down gracefully...", signal);
+        Stop();
+    };
+#ifdef _WIN32
+    pImpl->loop.WatchSignals({SIGINT, SIGTERM, SIGBREAK}, onSignal);
+#else
+    // SIGUSR1 dumps the trace without stopping
+    pImpl->loop.WatchSignals({SIGINT, SIGTERM, SIGUSR1}, onSignal);
+#endif
+    
+    pImpl->lastUpdate = std::chrono::steady_clock::now();
+    pImpl->loop.ArmTimer(pImpl->detectionTimer, std::chrono::milliseconds(0));
     
-    // Keep main thread alive
-    while (pImpl->running.load()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    LOG_INFO("FL Studio Discord Rich Presence is running, monitoring for FL Studio processes...");
+    
+    pImpl->loop.Run();
+    
+    // Shut down on the loop thread so the Discord client is never shared
+    pImpl->loop.DisarmTimer(pImpl->detectionTimer);
+    pImpl->detector->SetRecorder(nullptr);
+    pImpl->recorder.Close();
+    SaveSnapshot(pImpl->lastInfo, true);
+    pImpl->stateExport.Close();
+    ReportOverhead();
+    if (pImpl->recordingWatcher) {
+        pImpl->recordingWatcher->Stop();
     }
+    pImpl->bus.Publish(RenderedPresence());
+    pImpl->bus.UnsubscribeAll();
+    pImpl->discord->Shutdown();
+    EndUserSessions();
     
-    if (pImpl->updateThread.joinable()) {
-        pImpl->updateThread.join();
+    {
+        std::lock_guard<std::mutex> lock(pImpl->stopMutex);
+        pImpl->running.store(false);
     }
+    pImpl->stoppedCondition.notify_all();
+    
+    LOG_INFO("FL Studio Discord Rich Presence stopped");
 }
 
 void FLStudioDiscordApp::Stop() {
+    // Also covers a Stop() that races ahead of Run(): the loop exits at once
+    pImpl->loop.Stop();
     if (!pImpl->running.load()) return;
     
-    std::cout << "Stopping FL Studio Discord Rich Presence..." << std::endl;
-    pImpl->running.store(false);
-    
-    if (pImpl->updateThread.joinable()) {
-        pImpl->updateThread.join();
+    LOG_INFO("Stopping FL Studio Discord Rich Presence...");
+    if (std::this_thread::get_id() == pImpl->loopThread) {
+        return;  // Run() finishes the shutdown once the current callback returns
     }
     
-    pImpl->discord->ClearPresence();
-    pImpl->discord->Shutdown();
-    
-    std::cout << "FL Studio Discord Rich Presence stopped" << std::endl;
+    std::unique_lock<std::mutex> lock(pImpl->stopMutex);
+    pImpl->stoppedCondition.wait(lock, [this] { return !pImpl->running.load(); });
 }
 
 void FLStudioDiscordApp::SetUpdateInterval(std::chrono::milliseconds interval) {
     pImpl->updateInterval = interval;
     if (pImpl->detector) {
-        pImpl->detector->SetUpdateInterval(interval);
+        // A replay paces cycles itself; every cycle must reach the detector
+        pImpl->detector->SetUpdateInterval(pImpl->replay ? std::chrono::milliseconds(0) : interval);
+    }
+}
+
+bool FLStudioDiscordApp::StartRecording(const std::string& path) {
+    if (!pImpl->recorder.Open(path)) return false;
+    pImpl->detector->SetRecorder(&pImpl->recorder);
+    return true;
+}
+
+bool FLStudioDiscordApp::StartReplay(const std::string& path, bool realTime) {
+    auto replay = std::make_unique<DetectorReplay>();
+    std::string error;
+    if (!replay->Load(path, error)) {
+        LOG_ERROR("Cannot replay recording: {}", error);
+        return false;
+    }
+    if (replay->AtEnd()) {
+        LOG_ERROR("Recording {} contains no detection cycles", path);
+        return false;
+    }
+    
+    LOG_INFO("Replaying {} cycles ({} s recorded) at {} speed", replay->GetCycleCount(),
+             replay->GetDurationMs() / 1000, realTime ? "recorded" : "maximum");
+    
+    DetectorReplay* source = replay.get();
+    pImpl->detector->SetProcessSource([source] { return source->Current(); });
+    pImpl->detector->SetWindowTitleSource([](int) { return std::string(); });
+    pImpl->replay = std::move(replay);
+    pImpl->replayRealTime = realTime;
+    pImpl->replayStarted = std::chrono::steady_clock::now();
+    SetUpdateInterval(pImpl->updateInterval);
+    return true;
+}
+
+void FLStudioDiscordApp::ApplyConfig(const AppConfig& config) {
+    // Startup enforces the same rules as a reload, but anything a reload
+    // would reject is reset to its default instead of stopping the daemon
+    auto snapshot = std::make_unique<AppConfig>(config);
+    std::string errors;
+    snapshot->ResetInvalid(errors);
+    ResetInvalidPresenceRules(*snapshot, errors);
+    if (!errors.empty()) {
+        LOG_WARNING("Invalid settings, using their defaults:");
+        LOG_WARNING_LINES(errors);
+    }
+    
+    pImpl->config.Publish(std::move(snapshot));
+    pImpl->appliedConfigVersion = pImpl->config.GetVersion();
+    ApplySnapshot(pImpl->config.Current());
+}
+
+void FLStudioDiscordApp::WatchConfigFile(const std::string& path) {
+    pImpl->configWatcher = std::make_unique<ConfigWatcher>(pImpl->loop, path, [this](const std::string& content) {
+        ReloadConfig(content);
+    });
+    pImpl->configWatcher->Start();
+}
+
+void FLStudioDiscordApp::ReloadConfig(const std::string& content) {
+    // Parse into a fresh snapshot and validate everything, including templates
+    // and privacy rules, before anything is published
+    auto snapshot = std::make_unique<AppConfig>();
+    std::string errors;
+    std::istringstream input(content);
+    bool valid = AppConfig::Parse(input, *snapshot, errors);
+    valid = snapshot->Validate(errors) && valid;
+    
+    PresenceRenderer renderer;
+    renderer.Configure(*snapshot, errors);
+    PrivacyMatcher privacy;
+    privacy.Compile(snapshot->hiddenProjects, errors);
+    
+    if (!valid || !errors.empty()) {
+        LOG_WARNING("Config change rejected, keeping previous settings:");
+        LOG_WARNING_LINES(errors);
+        return;
+    }
+    
+    pImpl->config.Publish(std::move(snapshot));
+    LOG_INFO("Configuration reloaded");
+    
+    // Pick the new snapshot up right away rather than at the next interval
+    if (pImpl->detectionTimer >= 0 && pImpl->running.load()) {
+        pImpl->loop.ArmTimer(pImpl->detectionTimer, std::chrono::milliseconds(0));
+    }
+}
+
+void FLStudioDiscordApp::ApplySnapshot(const AppConfig& config) {
+    // enableLogging: informational messages plus a rotated log file next to
+    // the config; otherwise only warnings and errors reach the console
+    Logger::Options logging;
+    if (config.enableLogging) {
+        logging.filePath = AppConfig::GetLogFilePath();
+    } else {
+        logging.minimumLevel = LogLevel::Warning;
+    }
+    Logger::Instance().Configure(logging);
+    
+    SetUpdateInterval(config.updateInterval);
+    pImpl->governor.SetBudget(config.cpuBudgetPercent);
+    if (config.recordingFolder != pImpl->recordingFolder) {
+        pImpl->recordingFolder = config.recordingFolder;
+        pImpl->recordingPid = 0;  // Resolve the folder again next cycle
+    }
+    pImpl->detector->SetExtraProcessNames(config.processNames);
+    UpdateSinks(config);
+    if (config.exportSharedState != pImpl->exportState) {
+        pImpl->exportState = config.exportSharedState;
+        pImpl->stateExportFailed = false;
+    }
+    pImpl->presenceTimeout = config.presenceTimeout;
+    pImpl->debounceHolds.projectCleared = config.debounceProject;
+    pImpl->debounceHolds.unsaved = config.debounceUnsaved;
+    pImpl->debounceHolds.playback = config.debouncePlayback;
+    pImpl->debounceHolds.recordingEnd = config.debounceRecordingEnd;
+    pImpl->debouncer.SetHolds(pImpl->debounceHolds);
+    for (auto& entry : pImpl->users) {
+        entry.second.debouncer.SetHolds(pImpl->debounceHolds);
+    }
+    pImpl->presenceEnabled = config.enableRichPresence;
+    pImpl->discord->SetSdkLocation(config.discordSdkPath);
+    pImpl->discord->SetApplicationId(config.applicationId);
+    pImpl->applicationId = config.applicationId;
+    for (auto& entry : pImpl->users) {
+        entry.second.discord->SetApplicationId(config.applicationId);
+    }
+    
+    std::string errors;
+    pImpl->renderer.Configure(config, errors);
+    if (!errors.empty()) {
+        LOG_WARNING("Invalid presence template, using defaults for:");
+        LOG_WARNING_LINES(errors);
+    }
+    
+    errors.clear();
+    if (!pImpl->privacy.Compile(config.hiddenProjects, errors)) {
+        LOG_WARNING("Ignoring invalid privacy rules:");
+        LOG_WARNING_LINES(errors);
+    }
+    if (pImpl->privacy.GetRuleCount() > 0) {
+        LOG_INFO("Loaded {} hidden project rule(s)", pImpl->privacy.GetRuleCount());
+    }
+    
+    // Rendering rules may have changed even if FL Studio's state has not
+    pImpl->forceUpdate = true;
+}
+
+void FLStudioDiscordApp::UpdateSinks(const AppConfig& config) {
+    auto& bus = pImpl->bus;
+    
+    // An overlay only ever shows the current state
+    if (config.overlayFile != pImpl->overlayFile) {
+        bus.Unsubscribe(pImpl->overlaySink);
+        pImpl->overlaySink = 0;
+        pImpl->overlayFile = config.overlayFile;
+        if (!pImpl->overlayFile.empty()) {
+            PresenceBus::SinkOptions latestOnly;
+            latestOnly.capacity = 1;
+            pImpl->overlaySink = bus.Subscribe(std::make_unique<OverlayFileSink>(pImpl->overlayFile), latestOnly);
+        }
+    }
+    
+    // A log keeps what it has queued and skips what does not fit
+    if (config.activityLogFile != pImpl->activityLogFile) {
+        bus.Unsubscribe(pImpl->activityLogSink);
+        pImpl->activityLogSink = 0;
+        pImpl->activityLogFile = config.activityLogFile;
+        if (!pImpl->activityLogFile.empty()) {
+            PresenceBus::SinkOptions backlog;
+            backlog.capacity = 256;
+            backlog.policy = PresenceBus::DropPolicy::DropNewest;
+            pImpl->activityLogSink = bus.Subscribe(std::make_unique<ActivityLogSink>(pImpl->activityLogFile), backlog);
+        }
+    }
+    
+    // Widgets want the current state; the server buffers per client itself
+    if (config.webSocketPort != pImpl->webSocketPort || config.webSocketOrigins != pImpl->webSocketOrigins) {
+        bus.Unsubscribe(pImpl->webSocketSink);
+        pImpl->webSocketSink = 0;
+        pImpl->webSocketPort = config.webSocketPort;
+        pImpl->webSocketOrigins = config.webSocketOrigins;
+        if (pImpl->webSocketPort > 0) {
+            auto server = std::make_unique<WebSocketSink>(pImpl->webSocketPort, pImpl->webSocketOrigins);
+            if (server->Start()) {
+                PresenceBus::SinkOptions latestOnly;
+                latestOnly.capacity = 1;
+                pImpl->webSocketSink = bus.Subscribe(std::move(server), latestOnly);
+            }
+        }
     }
 }
 
 void FLStudioDiscordApp::SetShowProjectName(bool show) {
-    pImpl->showProjectName = show;
+    pImpl->renderer.SetShowProjectName(show);
 }
 
 void FLStudioDiscordApp::SetShowBPM(bool show) {
-    pImpl->showBPM = show;
+    pImpl->renderer.SetShowBPM(show);
 }
 
-void FLStudioDiscordApp::UpdateLoop() {
-    auto lastPresenceUpdate = std::chrono::steady_clock::now();
-    
-    while (pImpl->running.load()) {
-        try {
-            // Run Discord callbacks (no-op in simulation)
-            pImpl->discord->RunCallbacks();
-            
-            FLStudioInfo currentInfo = pImpl->detector->GetCurrentInfo();
-            auto now = std::chrono::steady_clock::now();
-            
-            // Check if we should update Discord presence
-            bool shouldUpdate = (
-                currentInfo != pImpl->lastInfo ||
-                std::chrono::duration_cast<std::chrono::seconds>(now - lastPresenceUpdate).count() > 30
-            );
-            
-            if (shouldUpdate) {
-                pImpl->discord->UpdateRichPresence(currentInfo, [&](bool success, const std::string& error) {
-                    if (!success) {
-                        std::cerr << "Failed to update Discord presence: " << error << std::endl;
+FLStudioDetector& FLStudioDiscordApp::GetDetector() {
+    return *pImpl->detector;
+}
+
+void FLStudioDiscordApp::RunDetectionCycle() {
+    TRACE_SCOPE("DetectionCycle");
+    pImpl->governor.BeginCycle();
+    try {
+        uint64_t configVersion = pImpl->config.GetVersion();
+        if (configVersion != pImpl->appliedConfigVersion) {
+            pImpl->appliedConfigVersion = configVersion;
+            ApplySnapshot(pImpl->config.Current());
+        }
+        
+        auto now = std::chrono::steady_clock::now();
+        if (!pImpl->presenceEnabled) {
+            if (pImpl->presenceShown) {
+                pImpl->bus.Publish(RenderedPresence());
+                pImpl->presenceShown = false;
+            }
+            EndUserSessions();
+            pImpl->config.Quiesce(pImpl->configReader);
+            ScheduleNextCycle();
+            return;
+        }
+        
+        if (pImpl->multiUser) {
+            UpdateUserSessions(now);
+            pImpl->config.Quiesce(pImpl->configReader);
+            ScheduleNextCycle();
+            return;
+        }
+        
+        FLStudioInfo currentInfo = pImpl->detector->GetCurrentInfo();
+        UpdateRecordingWatch(currentInfo);
+        
+        // Scrub hidden projects before anything downstream sees the name
+        ScrubHiddenProjects(pImpl->privacy, currentInfo);
+        ExportState(currentInfo);
+        
+        // Local tools get the raw state; presence only what persisted. A
+        // replay runs on recorded time so its digest does not depend on speed.
+        auto debounceTime = now;
+        if (pImpl->replay) {
+            debounceTime = std::chrono::steady_clock::time_point(std::chrono::milliseconds(pImpl->replay->GetCurrentTimeMs()));
+        }
+        pImpl->debouncer.Apply(currentInfo, debounceTime);
+        
+        // Check if we should update Discord presence
+        bool shouldUpdate = (
+            pImpl->forceUpdate ||
+            !pImpl->presenceShown ||
+            currentInfo != pImpl->lastInfo ||
+            now - pImpl->lastUpdate > pImpl->presenceTimeout
+        );
+        
+        if (shouldUpdate) {
+            {
+                TRACE_SCOPE("RenderPresence");
+                pImpl->renderer.Render(currentInfo, pImpl->presence);
+            }
+            if (pImpl->replay) {
+                for (std::string_view field : {pImpl->presence.details.View(), pImpl->presence.state.View(),
+                                               std::string_view(pImpl->presence.smallImage)}) {
+                    for (unsigned char c : field) {
+                        pImpl->replayDigest = (pImpl->replayDigest ^ c) * 1099511628211ull;
                     }
-                });
-                
-                pImpl->lastInfo = currentInfo;
-                lastPresenceUpdate = now;
+                    pImpl->replayDigest = (pImpl->replayDigest ^ 0xFF) * 1099511628211ull;
+                }
+                ++pImpl->replayUpdates;
             }
+            TRACE_SCOPE("PublishPresence");
+            pImpl->bus.Publish(pImpl->presence);
             
-        } catch (const std::exception& e) {
-            std::cerr << "Error in update loop: " << e.what() << std::endl;
+            pImpl->lastInfo = currentInfo;
+            pImpl->lastUpdate = now;
+            pImpl->forceUpdate = false;
+            pImpl->presenceShown = true;
         }
         
-        // Sleep for the configured interval
-        std::this_thread::sleep_for(pImpl->updateInterval);
+        SaveSnapshot(currentInfo, false);
+        
+    } catch (const std::exception& e) {
+        LOG_ERROR("Error in update loop: {}", e.what());
     }
+    
+    // Done with this cycle's config snapshot
+    pImpl->config.Quiesce(pImpl->configReader);
+    ScheduleNextCycle();
+}
+
+void FLStudioDiscordApp::EnableMultiUser() {
+    pImpl->multiUser = true;
+    LOG_INFO("Multi-user mode: publishing presence to each user's Discord under /run/user/<uid>");
 }
 
-std::string FLStudioDiscordApp::BuildDetailsString(const FLStudioInfo& info) const {
-    if (!info.isRunning) {
-        return "FL Studio not running";
+void FLStudioDiscordApp::UpdateUserSessions(std::chrono::steady_clock::time_point now) {
+    auto instances = pImpl->detector->GetCurrentInfoByUser();
+    for (auto& entry : pImpl->users) {
+        entry.second.active = false;
     }
     
-    if (pImpl->showProjectName && !info.projectName.empty()) {
-        return "Working on " + info.projectName;
+    for (auto& instance : instances) {
+        auto& session = pImpl->users[instance.uid];
+        session.active = true;
+        if (!session.discord) {
+            session.discord = std::make_unique<DiscordClient>(pImpl->applicationId);
+            session.discord->SetRuntimeDirectory("/run/user/" + std::to_string(instance.uid));
+            session.discord->AttachToLoop(pImpl->loop);
+            session.discord->Initialize();
+            session.debouncer.SetHolds(pImpl->debounceHolds);
+            LOG_INFO("FL Studio started for uid {}", instance.uid);
+        }
+        
+        // Same rules as the single-user cycle, tracked per user
+        FLStudioInfo& info = instance.info;
+        ScrubHiddenProjects(pImpl->privacy, info);
+        session.debouncer.Apply(info, now);
+        
+        bool shouldUpdate = (
+            pImpl->forceUpdate ||
+            !session.presenceShown ||
+            info != session.lastInfo ||
+            now - session.lastUpdate > pImpl->presenceTimeout
+        );
+        if (!shouldUpdate) continue;
+        
+        pImpl->renderer.Render(info, session.presence);
+        int uid = instance.uid;
+        session.discord->UpdateRichPresence(session.presence, [uid](bool success, const std::string& error) {
+            if (!success) {
+                LOG_ERROR("Failed to update Discord presence for uid {}: {}", uid, error);
+            }
+        });
+        session.lastInfo = std::move(info);
+        session.lastUpdate = now;
+        session.presenceShown = true;
     }
+    pImpl->forceUpdate = false;
     
-    if (info.isRecording) {
-        return "Recording";
-    } else if (info.isPlaying) {
-        return "Playing";
-    } else {
-        return "Composing";
+    // FL Studio exited: clear that user's presence and hang up
+    for (auto it = pImpl->users.begin(); it != pImpl->users.end();) {
+        if (it->second.active) {
+            ++it;
+            continue;
+        }
+        LOG_INFO("FL Studio stopped for uid {}", it->first);
+        it->second.discord->ClearPresence();
+        it->second.discord->Shutdown();
+        it->second.discord->DetachFromLoop();
+        it = pImpl->users.erase(it);
+    }
+}
+
+void FLStudioDiscordApp::EndUserSessions() {
+    for (auto& entry : pImpl->users) {
+        entry.second.discord->ClearPresence();
+        entry.second.discord->Shutdown();
+        entry.second.discord->DetachFromLoop();
+    }
+    pImpl->users.clear();
+}
+
+void FLStudioDiscordApp::UpdateRecordingWatch(FLStudioInfo& info) {
+    // Replayed processes have no folder to watch
+    if (!pImpl->recordingWatcher || pImpl->replay) return;
+    
+    int pid = info.isRunning ? info.processId : 0;
+    auto now = std::chrono::steady_clock::now();
+    
+    // FL creates Audio/Recorded on its first take, so a missing folder is looked up again now and then
+    bool lookupAgain = pid != 0 && pImpl->recordingFolder.empty() && pImpl->recordingWatcher->GetDirectory().empty() &&
+                       now - pImpl->lastRecordingLookup >= RECORDING_LOOKUP_INTERVAL;
+    if (pid != pImpl->recordingPid || lookupAgain) {
+        pImpl->recordingPid = pid;
+        pImpl->lastRecordingLookup = now;
+        std::string folder;
+        if (pid != 0) {
+            folder = pImpl->recordingFolder.empty() ? RecordingWatcher::FindRecordedFolder(pid) : pImpl->recordingFolder;
+        }
+        pImpl->recordingWatcher->Watch(folder);
+    }
+    info.isRecording = info.isRecording || pImpl->recordingWatcher->IsRecording();
+}
+
+void FLStudioDiscordApp::ExportState(const FLStudioInfo& info) {
+    // A replay is not the live state
+    if (!pImpl->exportState || pImpl->replay) {
+        pImpl->stateExport.Close();
+        return;
+    }
+    if (!pImpl->stateExport.IsOpen() && !pImpl->stateExportFailed && !pImpl->stateExport.Open()) {
+        pImpl->stateExportFailed = true;  // Warned once; retried after a config change
     }
+    pImpl->stateExport.Publish(info);
 }
 
-std::string FLStudioDiscordApp::BuildStateString(const FLStudioInfo& info) const {
-    std::string state = info.version;
+void FLStudioDiscordApp::EnableWarmStart(const std::string& snapshotPath) {
+    pImpl->snapshotPath = snapshotPath;
+}
+
+void FLStudioDiscordApp::RestoreSnapshot() {
+    if (pImpl->snapshotPath.empty() || pImpl->replay || pImpl->multiUser) return;
+    
+    SessionSnapshot snapshot;
+    if (!SessionSnapshot::Load(pImpl->snapshotPath, snapshot) || snapshot.pid <= 0) return;
+    
+    // One cheap probe of the saved PID instead of a full scan; a reused PID
+    // has a different start time
+    if (snapshot.processStart == 0 ||
+        CrossPlatformProcessDetector::GetProcessStartTime(snapshot.pid) != snapshot.processStart) {
+        LOG_INFO("FL Studio session from the snapshot has ended");
+        return;
+    }
+    
+    pImpl->detector->Restore(snapshot.info);
+    pImpl->savedSnapshot = snapshot;
+    pImpl->lastSnapshotSave = std::chrono::steady_clock::now();
+    LOG_INFO("Restored FL Studio session (PID {}) from snapshot", snapshot.pid);
+}
+
+void FLStudioDiscordApp::SaveSnapshot(const FLStudioInfo& info, bool force) {
+    if (pImpl->snapshotPath.empty() || pImpl->replay || pImpl->multiUser) return;
     
-    if (pImpl->showBPM && info.bpm > 0) {
-        state += " • " + std::to_string(info.bpm) + " BPM";
+    // Rewrite when the session changes, and now and then to keep the file fresh
+    auto now = std::chrono::steady_clock::now();
+    const FLStudioInfo& saved = pImpl->savedSnapshot.info;
+    int pid = info.isRunning ? info.processId : 0;
+    bool changed = pid != pImpl->savedSnapshot.pid || info.projectName != saved.projectName ||
+                   info.sessionStartTime != saved.sessionStartTime;
+    if (!force && !changed && now - pImpl->lastSnapshotSave < SNAPSHOT_INTERVAL) return;
+    
+    SessionSnapshot snapshot;
+    snapshot.pid = pid;
+    snapshot.processStart = pid == pImpl->savedSnapshot.pid ? pImpl->savedSnapshot.processStart : 0;
+    if (pid > 0 && snapshot.processStart == 0) {
+        snapshot.processStart = CrossPlatformProcessDetector::GetProcessStartTime(pid);
     }
+    snapshot.info = info;
+    snapshot.Save(pImpl->snapshotPath);
+    pImpl->savedSnapshot = std::move(snapshot);
+    pImpl->lastSnapshotSave = now;
+}
+
+void FLStudioDiscordApp::UpdateEconomy() {
+    pImpl->governor.EndCycle();
     
-    if (info.hasUnsavedChanges) {
-        state += " • Unsaved changes";
+    CpuGovernor::Level level = pImpl->governor.GetLevel();
+    if (level != pImpl->economyLevel) {
+        pImpl->economyLevel = level;
+        pImpl->detector->SetEconomy(level >= CpuGovernor::Level::Lean, level >= CpuGovernor::Level::Minimal);
     }
     
-    return state;
+    auto now = std::chrono::steady_clock::now();
+    if (now - pImpl->lastOverheadReport >= OVERHEAD_REPORT_INTERVAL) {
+        pImpl->lastOverheadReport = now;
+        ReportOverhead();
+    }
+}
+
+void FLStudioDiscordApp::ReportOverhead() {
+    auto report = pImpl->governor.GetReport();
+    if (report.cycles == 0) return;
+    LOG_INFO("Self overhead: {}% of a core (budget {}%), {} cycles at {} us avg / {} us max, {} detection",
+             report.usagePercent, report.budgetPercent, report.cycles, report.cycleAverage.count(),
+             report.cycleMax.count(), CpuGovernor::GetLevelName(report.level));
+    for (const auto& sink : pImpl->bus.GetStats()) {
+        LOG_INFO("Presence sink '{}': {} delivered, {} dropped, {} queued", sink.name, sink.delivered, sink.dropped,
+                 sink.queued);
+    }
+    
+    const auto& debounce = pImpl->debouncer.GetStats();
+    uint64_t delayed = debounce.project.delayed + debounce.unsaved.delayed + debounce.playback.delayed +
+                       debounce.recording.delayed;
+    LOG_INFO("Debounce: {} change(s) shown after their hold; suppressed project {}, unsaved {}, playback {}, recording {}",
+             delayed, debounce.project.suppressed, debounce.unsaved.suppressed, debounce.playback.suppressed,
+             debounce.recording.suppressed);
+}
+
+CpuGovernor::Report FLStudioDiscordApp::GetOverheadReport() const {
+    return pImpl->governor.GetReport();
+}
+
+StateDebouncer::Stats FLStudioDiscordApp::GetDebounceStats() const {
+    return pImpl->debouncer.GetStats();
+}
+
+void FLStudioDiscordApp::ScheduleNextCycle() {
+    if (!pImpl->replay) {
+        UpdateEconomy();
+        
+        // Measure from the end of the scan so the detector's own throttle
+        // never makes us skip a cycle
+        auto delay = pImpl->governor.Stretch(pImpl->updateInterval);
+        
+        // A held change goes out as soon as a fresh look confirms it, not
+        // an interval later
+        auto deadline = pImpl->debouncer.GetNextDeadline();
+        for (const auto& entry : pImpl->users) {
+            deadline = std::min(deadline, entry.second.debouncer.GetNextDeadline());
+        }
+        if (deadline != std::chrono::steady_clock::time_point::max()) {
+            auto untilDeadline = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            if (untilDeadline < delay) {
+                delay = std::max(untilDeadline, std::chrono::milliseconds(0));
+                pImpl->detector->RequestRefresh();
+            }
+        }
+        pImpl->loop.ArmTimer(pImpl->detectionTimer, delay);
+        return;
+    }
+    
+    DetectorReplay& replay = *pImpl->replay;
+    auto delay = std::chrono::milliseconds(pImpl->replayRealTime ? replay.GetDelayToNextMs() : 0);
+    replay.Advance();
+    if (!replay.AtEnd()) {
+        pImpl->loop.ArmTimer(pImpl->detectionTimer, delay);
+        return;
+    }
+    
+    // Same recording and config always give the same digest
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - pImpl->replayStarted).count();
+    char digest[17];
+    std::snprintf(digest, sizeof(digest), "%016llx", static_cast<unsigned long long>(pImpl->replayDigest));
+    LOG_INFO("Replay finished: {} cycles in {} ms, {} presence updates, digest {}",
+             replay.GetCycleCount(), elapsed, pImpl->replayUpdates, digest);
+    Stop();
 }
\ No newline at end of file
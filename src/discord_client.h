@@ -7,16 +7,27 @@
 #include <thread>
 #include <chrono>
 
-// Include CORRECT Discord Partner SDK header
-#include "../discord_social_sdk/include/discordpp.h"
-
 #include "../include/fl_studio_types.h"
+#include "presence_renderer.h"
+#include "cpu_governor.h"
+#include "state_debouncer.h"
+
+struct AppConfig;
+class EventLoop;
 
 // Forward declare FL Studio detector to avoid circular dependency
 class FLStudioDetector;
 
 class DiscordClient {
 public:
+    // Connection lifecycle, advanced by RunCallbacks()
+    enum class ConnectionState {
+        Disconnected,
+        Connecting,
+        Handshaking,
+        Ready
+    };
+    
     using UpdateCallback = std::function<void(bool success, const std::string& error)>;
     
     explicit DiscordClient(const std::string& applicationId);
@@ -25,15 +36,36 @@ public:
     // Core functionality
     bool Initialize();
     void Shutdown();
-    void RunCallbacks(); // Must be called regularly
+    void RunCallbacks(); // Must be called regularly, or driven by AttachToLoop()
+    
+    // Lets socket readiness and connection deadlines drive RunCallbacks(),
+    // so an idle, connected client causes no wakeups at all
+    void AttachToLoop(EventLoop& loop);
+    // Releases the loop's socket watch and timer; call before destroying a
+    // client whose loop lives on
+    void DetachFromLoop();
+    
+    // Optional Discord Partner SDK ("auto" or a library path), loaded on the
+    // first RunCallbacks() after this is set. Empty keeps the client IPC-only.
+    void SetSdkLocation(const std::string& location);
+    
+    // Takes effect on the next handshake; an open connection is re-established
+    void SetApplicationId(const std::string& applicationId);
+    
+    // Connect to the Discord socket under this directory only (multi-user mode)
+    void SetRuntimeDirectory(const std::string& directory);
     
     // Rich Presence
-    void UpdateRichPresence(const FLStudioInfo& info, UpdateCallback callback = nullptr);
+    void UpdateRichPresence(const RenderedPresence& presence, UpdateCallback callback = nullptr);
     void ClearPresence();
     
     // Status
     bool IsConnected() const;
     bool IsInitialized() const;
+    ConnectionState GetConnectionState() const;
+    
+    // How long the caller may sleep before RunCallbacks() has work to do
+    std::chrono::milliseconds GetTimeUntilNextAction() const;
     
 private:
     class Impl;
@@ -51,14 +83,53 @@ public:
     void Stop();
     
     // Configuration
+    void ApplyConfig(const AppConfig& config);
+    // Reloads the file when it changes; invalid edits keep the current settings
+    void WatchConfigFile(const std::string& path);
     void SetUpdateInterval(std::chrono::milliseconds interval);
     void SetShowProjectName(bool show);
     void SetShowBPM(bool show);
     
+    // Detection pipeline, e.g. to inject process/title sources
+    FLStudioDetector& GetDetector();
+    
+    // Record the detector's input to a file, or replay a recording through
+    // detection and presence instead of the live system. A replay stops the
+    // app once the recording ends; realTime keeps the recorded pacing,
+    // otherwise cycles run back to back.
+    bool StartRecording(const std::string& path);
+    bool StartReplay(const std::string& path, bool realTime);
+    
+    // Shared-machine server mode (Linux, needs privileges to reach other
+    // users' sockets): one scan per cycle finds every user's FL Studio and
+    // each user gets presence on the Discord under /run/user/<uid>. Call
+    // before Initialize().
+    void EnableMultiUser();
+    
+    // Saves the session to snapshotPath periodically and at shutdown, and
+    // restores it in Initialize() if the same FL Studio process is still
+    // running, so presence survives a daemon restart. Call before Initialize().
+    void EnableWarmStart(const std::string& snapshotPath);
+    
+    // Own CPU cost as measured by the budget governor (cpuBudgetPercent)
+    CpuGovernor::Report GetOverheadReport() const;
+    // Transient states kept off the presence (debounce* settings)
+    StateDebouncer::Stats GetDebounceStats() const;
+    
 private:
-    void UpdateLoop();
-    std::string BuildDetailsString(const FLStudioInfo& info) const;
-    std::string BuildStateString(const FLStudioInfo& info) const;
+    void RunDetectionCycle();
+    void ScheduleNextCycle();
+    void UpdateUserSessions(std::chrono::steady_clock::time_point now);
+    void EndUserSessions();
+    void UpdateEconomy();
+    void UpdateRecordingWatch(FLStudioInfo& info);
+    void ExportState(const FLStudioInfo& info);
+    void RestoreSnapshot();
+    void SaveSnapshot(const FLStudioInfo& info, bool force);
+    void ReportOverhead();
+    void ReloadConfig(const std::string& content);
+    void ApplySnapshot(const AppConfig& config);
+    void UpdateSinks(const AppConfig& config);
     
     // Use Pimpl pattern to avoid incomplete type issues
     class AppImpl;
@@ -0,0 +1,334 @@
+#include "discord_ipc.h"
+#include <cstring>
+#include <cstdlib>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <unistd.h>
+    #include <fcntl.h>
+    #include <errno.h>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <sys/stat.h>
+    #include <sys/un.h>
+#endif
+
+namespace {
+    constexpr size_t FRAME_HEADER_SIZE = 8;
+    constexpr uint32_t MAX_FRAME_SIZE = 64 * 1024;
+
+    void WriteLE32(char* out, uint32_t value) {
+        out[0] = static_cast<char>(value & 0xFF);
+        out[1] = static_cast<char>((value >> 8) & 0xFF);
+        out[2] = static_cast<char>((value >> 16) & 0xFF);
+        out[3] = static_cast<char>((value >> 24) & 0xFF);
+    }
+
+    uint32_t ReadLE32(const char* in) {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(in);
+        return static_cast<uint32_t>(bytes[0]) |
+               (static_cast<uint32_t>(bytes[1]) << 8) |
+               (static_cast<uint32_t>(bytes[2]) << 16) |
+               (static_cast<uint32_t>(bytes[3]) << 24);
+    }
+}
+
+DiscordIpcTransport::~DiscordIpcTransport() {
+    Close();
+}
+
+std::vector<std::string> DiscordIpcTransport::GetSocketCandidates(const std::string& runtimeDirectory) {
+    std::vector<std::string> candidates;
+
+#ifdef _WIN32
+    for (int i = 0; i < 10; ++i) {
+        candidates.push_back("\\\\?\\pipe\\discord-ipc-" + std::to_string(i));
+    }
+#else
+    std::vector<std::string> baseDirs;
+    if (!runtimeDirectory.empty()) {
+        baseDirs.push_back(runtimeDirectory);
+    } else {
+        for (const char* var : {"XDG_RUNTIME_DIR", "TMPDIR", "TMP", "TEMP"}) {
+            const char* value = getenv(var);
+            if (value && *value) {
+                baseDirs.push_back(value);
+            }
+        }
+        baseDirs.push_back("/tmp");
+    }
+
+    // Flatpak and Snap builds of Discord place the socket in a sandbox subdirectory
+    const char* sandboxDirs[] = {"", "/app/com.discordapp.Discord", "/snap.discord"};
+
+    for (int i = 0; i < 10; ++i) {
+        for (const auto& base : baseDirs) {
+            for (const char* sandbox : sandboxDirs) {
+                candidates.push_back(base + sandbox + "/discord-ipc-" + std::to_string(i));
+            }
+        }
+    }
+#endif
+
+    return candidates;
+}
+
+#ifdef _WIN32
+
+DiscordIpcTransport::IoResult DiscordIpcTransport::Connect() {
+    Close();
+
+    for (const auto& path : GetSocketCandidates(runtimeDirectory)) {
+        HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+                                    OPEN_EXISTING, 0, nullptr);
+        if (handle != INVALID_HANDLE_VALUE) {
+            pipe = handle;
+            connectedPath = path;
+            return IoResult::Ok;
+        }
+    }
+
+    return IoResult::Error;
+}
+
+DiscordIpcTransport::IoResult DiscordIpcTransport::FinishConnect() {
+    return IsOpen() ? IoResult::Ok : IoResult::Error;
+}
+
+void DiscordIpcTransport::Close() {
+    if (pipe) {
+        CloseHandle(static_cast<HANDLE>(pipe));
+        pipe = nullptr;
+    }
+    connectedPath.clear();
+    readBuffer.clear();
+}
+
+bool DiscordIpcTransport::IsOpen() const {
+    return pipe != nullptr;
+}
+
+int DiscordIpcTransport::GetPollFd() const {
+    return -1;
+}
+
+bool DiscordIpcTransport::SendFrame(Opcode opcode, std::string_view payload) {
+    if (!IsOpen()) return false;
+
+    EncodeFrame(opcode, payload);
+    const std::string& frame = writeBuffer;
+
+    DWORD written = 0;
+    if (!WriteFile(static_cast<HANDLE>(pipe), frame.data(), static_cast<DWORD>(frame.size()), &written, nullptr) ||
+        written != frame.size()) {
+        return false;
+    }
+    return true;
+}
+
+DiscordIpcTransport::IoResult DiscordIpcTransport::FillReadBuffer() {
+    DWORD available = 0;
+    if (!PeekNamedPipe(static_cast<HANDLE>(pipe), nullptr, 0, nullptr, &available, nullptr)) {
+        return IoResult::Closed;
+    }
+    if (available == 0) {
+        return IoResult::WouldBlock;
+    }
+
+    char buffer[4096];
+    DWORD toRead = available < sizeof(buffer) ? available : sizeof(buffer);
+    DWORD bytesRead = 0;
+    if (!ReadFile(static_cast<HANDLE>(pipe), buffer, toRead, &bytesRead, nullptr)) {
+        return IoResult::Closed;
+    }
+    readBuffer.append(buffer, bytesRead);
+    return IoResult::Ok;
+}
+
+#else // POSIX
+
+DiscordIpcTransport::IoResult DiscordIpcTransport::Connect() {
+    Close();
+
+    for (const auto& path : GetSocketCandidates(runtimeDirectory)) {
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0 || !S_ISSOCK(st.st_mode)) {
+            continue;
+        }
+
+        sockaddr_un addr{};
+        if (path.size() >= sizeof(addr.sun_path)) {
+            continue;
+        }
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+        int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (sock < 0) {
+            return IoResult::Error;
+        }
+        fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+        fcntl(sock, F_SETFD, FD_CLOEXEC);
+#ifdef SO_NOSIGPIPE
+        int one = 1;
+        setsockopt(sock, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+        if (connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+            fd = sock;
+            connectedPath = path;
+            return IoResult::Ok;
+        }
+
+        if (errno == EINPROGRESS || errno == EAGAIN) {
+            fd = sock;
+            connectedPath = path;
+            return IoResult::WouldBlock;
+        }
+
+        // Stale socket file (Discord crashed) - try the next candidate
+        close(sock);
+    }
+
+    return IoResult::Error;
+}
+
+DiscordIpcTransport::IoResult DiscordIpcTransport::FinishConnect() {
+    if (!IsOpen()) return IoResult::Error;
+
+    pollfd pfd{fd, POLLOUT, 0};
+    int ready = poll(&pfd, 1, 0);
+    if (ready == 0) {
+        return IoResult::WouldBlock;
+    }
+    if (ready < 0) {
+        return IoResult::Error;
+    }
+
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) != 0 || error != 0) {
+        return IoResult::Error;
+    }
+    return IoResult::Ok;
+}
+
+void DiscordIpcTransport::Close() {
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+    connectedPath.clear();
+    readBuffer.clear();
+}
+
+bool DiscordIpcTransport::IsOpen() const {
+    return fd >= 0;
+}
+
+int DiscordIpcTransport::GetPollFd() const {
+    return fd;
+}
+
+bool DiscordIpcTransport::SendFrame(Opcode opcode, std::string_view payload) {
+    if (!IsOpen()) return false;
+
+    EncodeFrame(opcode, payload);
+    const std::string& frame = writeBuffer;
+
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+
+    size_t sent = 0;
+    while (sent < frame.size()) {
+        ssize_t result = send(fd, frame.data() + sent, frame.size() - sent, flags);
+        if (result > 0) {
+            sent += static_cast<size_t>(result);
+            continue;
+        }
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // Frames are tiny; a full socket buffer means Discord stopped reading.
+            // Wait briefly for room rather than sending a torn frame.
+            pollfd pfd{fd, POLLOUT, 0};
+            if (poll(&pfd, 1, 50) > 0) {
+                continue;
+            }
+        }
+        return false;
+    }
+    return true;
+}
+
+DiscordIpcTransport::IoResult DiscordIpcTransport::FillReadBuffer() {
+    char buffer[4096];
+    ssize_t result = recv(fd, buffer, sizeof(buffer), 0);
+    if (result > 0) {
+        readBuffer.append(buffer, static_cast<size_t>(result));
+        return IoResult::Ok;
+    }
+    if (result == 0) {
+        return IoResult::Closed;
+    }
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        return IoResult::WouldBlock;
+    }
+    return IoResult::Error;
+}
+
+#endif
+
+void DiscordIpcTransport::EncodeFrame(Opcode opcode, std::string_view payload) {
+    writeBuffer.resize(FRAME_HEADER_SIZE);
+    WriteLE32(&writeBuffer[0], static_cast<uint32_t>(opcode));
+    WriteLE32(&writeBuffer[4], static_cast<uint32_t>(payload.size()));
+    writeBuffer.append(payload.data(), payload.size());
+}
+
+DiscordIpcTransport::IoResult DiscordIpcTransport::ReadFrame(Opcode& opcode, std::string& payload) {
+    if (!IsOpen()) return IoResult::Closed;
+
+    while (true) {
+        if (readBuffer.size() >= FRAME_HEADER_SIZE) {
+            uint32_t length = ReadLE32(readBuffer.data() + 4);
+            if (length > MAX_FRAME_SIZE) {
+                return IoResult::Error;
+            }
+            if (readBuffer.size() >= FRAME_HEADER_SIZE + length) {
+                opcode = static_cast<Opcode>(ReadLE32(readBuffer.data()));
+                payload.assign(readBuffer, FRAME_HEADER_SIZE, length);
+                readBuffer.erase(0, FRAME_HEADER_SIZE + length);
+                return IoResult::Ok;
+            }
+        }
+
+        IoResult result = FillReadBuffer();
+        if (result != IoResult::Ok) {
+            return result;
+        }
+    }
+}
+
+bool JsonFieldEquals(const std::string& payload, const char* key, const char* value) {
+    std::string quotedKey = std::string("\"") + key + "\"";
+    std::string quotedValue = std::string("\"") + value + "\"";
+    
+    size_t pos = payload.find(quotedKey);
+    while (pos != std::string::npos) {
+        size_t cursor = payload.find_first_not_of(" \t\r\n", pos + quotedKey.size());
+        if (cursor != std::string::npos && payload[cursor] == ':') {
+            cursor = payload.find_first_not_of(" \t\r\n", cursor + 1);
+            if (cursor != std::string::npos && payload.compare(cursor, quotedValue.size(), quotedValue) == 0) {
+                return true;
+            }
+        }
+        pos = payload.find(quotedKey, pos + 1);
+    }
+    return false;
+}
\ No newline at end of file
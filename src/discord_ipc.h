@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Minimal Discord local RPC transport.
+// Frames are: uint32 opcode (LE) | uint32 length (LE) | JSON payload.
+// All operations are non-blocking so the update loop never stalls on Discord.
+class DiscordIpcTransport {
+public:
+    enum class Opcode : uint32_t {
+        Handshake = 0,
+        Frame = 1,
+        Close = 2,
+        Ping = 3,
+        Pong = 4
+    };
+
+    enum class IoResult {
+        Ok,
+        WouldBlock,
+        Closed,
+        Error
+    };
+
+    DiscordIpcTransport() = default;
+    ~DiscordIpcTransport();
+
+    DiscordIpcTransport(const DiscordIpcTransport&) = delete;
+    DiscordIpcTransport& operator=(const DiscordIpcTransport&) = delete;
+
+    // Connection management
+    IoResult Connect();       // Starts connecting to the first available discord-ipc-N
+    IoResult FinishConnect(); // Completes a connect that returned WouldBlock
+    void Close();
+    bool IsOpen() const;
+    int GetPollFd() const;    // Socket to watch for readiness, -1 where not pollable (Windows pipes)
+
+    // Framing
+    bool SendFrame(Opcode opcode, std::string_view payload);
+    IoResult ReadFrame(Opcode& opcode, std::string& payload);
+
+    const std::string& GetConnectedPath() const { return connectedPath; }
+
+    // Looks for the socket only under this directory (e.g. another user's
+    // /run/user/<uid>) instead of our own runtime and temp directories
+    void SetRuntimeDirectory(const std::string& directory) { runtimeDirectory = directory; }
+
+    // Candidate socket/pipe paths, most likely first
+    static std::vector<std::string> GetSocketCandidates(const std::string& runtimeDirectory = "");
+
+private:
+    IoResult FillReadBuffer();
+    // Builds header + payload into writeBuffer, reusing its capacity
+    void EncodeFrame(Opcode opcode, std::string_view payload);
+
+#ifdef _WIN32
+    void* pipe = nullptr;
+#else
+    int fd = -1;
+#endif
+    std::string connectedPath;
+    std::string runtimeDirectory;
+    std::string readBuffer;
+    std::string writeBuffer;
+};
+
+// Cheap check for "key": "value" in a flat RPC response, tolerant of whitespace
+bool JsonFieldEquals(const std::string& payload, const char* key, const char* value);
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "discord_sdk.h"
+#include <cstdlib>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <dlfcn.h>
+#endif
+
+namespace {
+#if defined(_WIN32)
+    constexpr const char* LIBRARY_NAME = "discord_partner_sdk.dll";
+#elif defined(__APPLE__)
+    constexpr const char* LIBRARY_NAME = "libdiscord_partner_sdk.dylib";
+#else
+    constexpr const char* LIBRARY_NAME = "libdiscord_partner_sdk.so";
+#endif
+
+    void* OpenLibrary(const std::string& path, std::string& error) {
+#ifdef _WIN32
+        HMODULE module = LoadLibraryA(path.c_str());
+        if (!module) {
+            error = path + ": LoadLibrary failed (error " + std::to_string(GetLastError()) + ")";
+        }
+        return reinterpret_cast<void*>(module);
+#else
+        // RTLD_LAZY: only the symbols we actually call get resolved
+        void* library = dlopen(path.c_str(), RTLD_LAZY | RTLD_LOCAL);
+        if (!library) {
+            const char* message = dlerror();
+            error = message ? message : path + ": dlopen failed";
+        }
+        return library;
+#endif
+    }
+
+    void* FindSymbol(void* library, const char* name) {
+#ifdef _WIN32
+        return reinterpret_cast<void*>(GetProcAddress(static_cast<HMODULE>(library), name));
+#else
+        return dlsym(library, name);
+#endif
+    }
+
+    void CloseLibrary(void* library) {
+#ifdef _WIN32
+        FreeLibrary(static_cast<HMODULE>(library));
+#else
+        dlclose(library);
+#endif
+    }
+}
+
+DiscordSdk::~DiscordSdk() {
+    if (handle) {
+        CloseLibrary(handle);
+    }
+}
+
+std::vector<std::string> DiscordSdk::GetSearchPaths() {
+    std::vector<std::string> paths;
+
+    if (const char* path = std::getenv("FLRPC_DISCORD_SDK")) {
+        if (*path) paths.push_back(path);
+    }
+
+#ifdef FLRPC_DISCORD_SDK_DIR
+    #ifdef _WIN32
+    paths.push_back(std::string(FLRPC_DISCORD_SDK_DIR) + "/bin/release/" + LIBRARY_NAME);
+    paths.push_back(std::string(FLRPC_DISCORD_SDK_DIR) + "/bin/debug/" + LIBRARY_NAME);
+    #else
+    paths.push_back(std::string(FLRPC_DISCORD_SDK_DIR) + "/lib/release/" + LIBRARY_NAME);
+    paths.push_back(std::string(FLRPC_DISCORD_SDK_DIR) + "/lib/debug/" + LIBRARY_NAME);
+    #endif
+#endif
+
+    // Bare name: next to the executable on Windows, LD_LIBRARY_PATH/ld.so.cache elsewhere
+    paths.push_back(LIBRARY_NAME);
+    return paths;
+}
+
+bool DiscordSdk::EnsureLoaded(const std::string& location, std::string& error) {
+    if (attempted) {
+        error = loadError;
+        return IsLoaded();
+    }
+    attempted = true;
+
+    std::vector<std::string> candidates;
+    if (location == "auto") {
+        candidates = GetSearchPaths();
+    } else {
+        candidates.push_back(location);
+    }
+
+    for (const auto& path : candidates) {
+        std::string openError;
+        void* library = OpenLibrary(path, openError);
+        if (!library) {
+            loadError += openError + "\n";
+            continue;
+        }
+
+        auto runCallbacksSymbol = FindSymbol(library, "Discord_RunCallbacks");
+        if (!runCallbacksSymbol) {
+            loadError += path + ": missing Discord_RunCallbacks, not a Discord Partner SDK build\n";
+            CloseLibrary(library);
+            continue;
+        }
+
+        handle = library;
+        loadedPath = path;
+        runCallbacks = reinterpret_cast<RunCallbacksFn>(runCallbacksSymbol);
+        loadError.clear();
+        return true;
+    }
+
+    error = loadError;
+    return false;
+}
+
+void DiscordSdk::RunCallbacks() {
+    if (runCallbacks) {
+        runCallbacks();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Discord Partner SDK, resolved at runtime with dlopen/dlsym (LoadLibrary on
+// Windows) the first time something asks for it. Presence itself goes over
+// the local RPC socket, so the daemon builds, starts and runs without the
+// SDK, and never pays for loading and relocating it unless configured to.
+class DiscordSdk {
+public:
+    DiscordSdk() = default;
+    ~DiscordSdk();
+
+    DiscordSdk(const DiscordSdk&) = delete;
+    DiscordSdk& operator=(const DiscordSdk&) = delete;
+
+    // "auto" searches the usual locations, anything else is a library path.
+    // Loads once; later calls return the first result.
+    bool EnsureLoaded(const std::string& location, std::string& error);
+
+    bool IsLoaded() const { return handle != nullptr; }
+    const std::string& GetLoadedPath() const { return loadedPath; }
+
+    // Pumps SDK callbacks; no-op until loaded
+    void RunCallbacks();
+
+    // Search order for "auto": $FLRPC_DISCORD_SDK, the SDK directory found at
+    // build time (release before debug), then the platform loader's own path
+    static std::vector<std::string> GetSearchPaths();
+
+private:
+    using RunCallbacksFn = void (*)();
+
+    void* handle = nullptr;
+    bool attempted = false;
+    std::string loadedPath;
+    std::string loadError;
+    RunCallbacksFn runCallbacks = nullptr;
+};
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "enrichment_pipeline.h"
+#include "logger.h"
+
+#ifndef _WIN32
+    #include <csignal>
+    #include <pthread.h>
+#endif
+
+EnrichmentPipeline::EnrichmentPipeline(size_t workerCount)
+    : shared(std::make_shared<Shared>())
+    , workerCount(workerCount > 0 ? workerCount : 1) {
+}
+
+EnrichmentPipeline::~EnrichmentPipeline() {
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    shared->stopping = true;
+    shared->wake.notify_all();
+
+    // Idle workers exit at once. One stuck in a hung helper cannot be
+    // joined; it is left to finish on its own and owns the shared state.
+    bool exited = shared->finished.wait_for(lock, SHUTDOWN_GRACE, [this] { return shared->liveWorkers == 0; });
+    lock.unlock();
+    for (auto& worker : workers) {
+        if (exited) {
+            worker.join();
+        } else {
+            worker.detach();
+        }
+    }
+    if (!exited) {
+        LOG_WARNING("An enrichment stage is still running at shutdown; leaving it behind");
+    }
+}
+
+void EnrichmentPipeline::Submit(const std::shared_ptr<Ticket>& ticket, std::function<void()> run) {
+    tickets.push_back(ticket);
+
+    std::lock_guard<std::mutex> lock(shared->mutex);
+    // Workers start with the first stage; injected sources never need them
+    while (workers.size() < workerCount) {
+        ++shared->liveWorkers;
+        workers.emplace_back(RunWorker, shared);
+    }
+    std::shared_ptr<Shared> pool = shared;
+    shared->queue.push_back([pool, ticket, run = std::move(run)] {
+        run();
+        std::lock_guard<std::mutex> done(pool->mutex);
+        ticket->done = true;
+        pool->finished.notify_all();
+    });
+    shared->wake.notify_one();
+}
+
+size_t EnrichmentPipeline::Wait() {
+    size_t missed = 0;
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    for (const auto& ticket : tickets) {
+        bool done = shared->finished.wait_until(lock, ticket->deadline, [&ticket] { return ticket->done; });
+        if (!done) ++missed;
+
+        // A stage that keeps timing out is reported once, not every cycle
+        if (!done && !*ticket->overdue) {
+            LOG_WARNING("Enrichment stage '{}' missed its deadline, using its last known value", ticket->name);
+        }
+        *ticket->overdue = !done;
+    }
+    lock.unlock();
+    tickets.clear();
+    return missed;
+}
+
+void EnrichmentPipeline::RunWorker(const std::shared_ptr<Shared>& pool) {
+#ifndef _WIN32
+    // Signals belong to the event loop's signalfd, never to this thread
+    sigset_t all;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, nullptr);
+#endif
+
+    std::unique_lock<std::mutex> lock(pool->mutex);
+    while (true) {
+        pool->wake.wait(lock, [&pool] { return pool->stopping || !pool->queue.empty(); });
+        if (pool->stopping) break;
+
+        auto run = std::move(pool->queue.front());
+        pool->queue.pop_front();
+        lock.unlock();
+        run();
+        lock.lock();
+    }
+    --pool->liveWorkers;
+    pool->finished.notify_all();
+}
\ No newline at end of file
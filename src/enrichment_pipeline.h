@@ -0,0 +1,143 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Runs the detector's per-instance enrichment (window title, Wine registry,
+// loaded plugins) as independent stages on a small worker pool, so one slow
+// or hung lookup - an xdotool waiting on a wedged X server - cannot stall
+// detection. Each stage has a deadline: the cycle waits for it at most that
+// long and otherwise goes on with the stage's last known value. An overrun
+// stage keeps its worker until it returns, its late result is kept for the
+// next cycle, and it is not started again in the meantime.
+class EnrichmentPipeline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // One stage of one instance: its latest result, shared with the worker
+    // running it so a late finish always has somewhere valid to write
+    template <typename T>
+    class Stage {
+    public:
+        explicit Stage(const char* name) : name(name) {}
+
+        // Last completed result; default-constructed before the first
+        T Latest() const {
+            std::lock_guard<std::mutex> lock(mutex);
+            return value;
+        }
+        // Copies the result out only if a run completed since `seen`
+        bool TakeNewer(uint64_t& seen, T& out) const {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (completed == seen) return false;
+            seen = completed;
+            out = value;
+            return true;
+        }
+
+    private:
+        friend class EnrichmentPipeline;
+
+        const char* name;
+        mutable std::mutex mutex;
+        T value{};
+        uint64_t completed = 0;
+        bool running = false;
+        bool overdue = false;       // Missed its last deadline; owner thread only
+    };
+
+    explicit EnrichmentPipeline(size_t workerCount = 3);
+    ~EnrichmentPipeline();
+
+    EnrichmentPipeline(const EnrichmentPipeline&) = delete;
+    EnrichmentPipeline& operator=(const EnrichmentPipeline&) = delete;
+
+    // Injected sources (benchmarks, replays) never block; running their
+    // stages on the caller keeps those runs deterministic
+    void SetInline(bool runInline) { inlineStages = runInline; }
+
+    // Queues a run of the stage for this cycle. Returns false, starting
+    // nothing, while its previous run is still going. The work must only use
+    // what it captures by value.
+    template <typename T, typename Work>
+    bool Start(const std::shared_ptr<Stage<T>>& stage, std::chrono::milliseconds deadline, Work work);
+
+    // Waits for the stages started since the last Wait(), each until its
+    // deadline. Returns how many missed it.
+    size_t Wait();
+
+private:
+    // Pool state outlives the pipeline while a hung stage holds a worker
+    struct Shared {
+        std::mutex mutex;
+        std::condition_variable wake;       // Work queued, or stopping
+        std::condition_variable finished;   // A run or a worker finished
+        std::deque<std::function<void()>> queue;
+        size_t liveWorkers = 0;
+        bool stopping = false;
+    };
+
+    struct Ticket {
+        const char* name;
+        bool* overdue;              // The stage's; tickets end with the Wait() of their cycle
+        Clock::time_point deadline;
+        bool done = false;          // Guarded by Shared::mutex
+    };
+
+    void Submit(const std::shared_ptr<Ticket>& ticket, std::function<void()> run);
+    static void RunWorker(const std::shared_ptr<Shared>& shared);
+
+    static constexpr std::chrono::seconds SHUTDOWN_GRACE{1};
+
+    std::shared_ptr<Shared> shared;
+    std::vector<std::thread> workers;
+    size_t workerCount;
+    bool inlineStages = false;
+    std::vector<std::shared_ptr<Ticket>> tickets;
+};
+
+template <typename T, typename Work>
+bool EnrichmentPipeline::Start(const std::shared_ptr<Stage<T>>& stage, std::chrono::milliseconds deadline, Work work) {
+    if (inlineStages) {
+        T value = work();
+        std::lock_guard<std::mutex> lock(stage->mutex);
+        stage->value = std::move(value);
+        ++stage->completed;
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(stage->mutex);
+        if (stage->running) return false;
+        stage->running = true;
+    }
+    auto ticket = std::make_shared<Ticket>();
+    ticket->name = stage->name;
+    ticket->overdue = &stage->overdue;
+    ticket->deadline = Clock::now() + deadline;
+    Submit(ticket, [stage, work = std::move(work)] {
+        // A failed run keeps the last known value
+        T value{};
+        bool succeeded = true;
+        try {
+            value = work();
+        } catch (...) {
+            succeeded = false;
+        }
+        std::lock_guard<std::mutex> lock(stage->mutex);
+        if (succeeded) {
+            stage->value = std::move(value);
+            ++stage->completed;
+        }
+        stage->running = false;
+    });
+    return true;
+}
\ No newline at end of file
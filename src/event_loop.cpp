@@ -0,0 +1,479 @@
+#include "event_loop.h"
+#include "logger.h"
+#include <atomic>
+#include <csignal>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#ifdef __linux__
+    #include <cerrno>
+    #include <cstring>
+    #include <pthread.h>
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include <sys/signalfd.h>
+    #include <sys/timerfd.h>
+    #include <unistd.h>
+#else
+    #include <condition_variable>
+#endif
+
+#ifdef __linux__
+
+namespace {
+    // epoll user data: source kind in the high half, fd or timer id in the low half
+    enum class SourceKind : uint32_t { Fd, Timer, Signal, Wakeup };
+
+    uint64_t PackSource(SourceKind kind, uint32_t key) {
+        return (static_cast<uint64_t>(kind) << 32) | key;
+    }
+
+    uint32_t ToEpollEvents(uint32_t events) {
+        uint32_t result = 0;
+        if (events & EventLoop::Readable) result |= EPOLLIN | EPOLLRDHUP;
+        if (events & EventLoop::Writable) result |= EPOLLOUT;
+        return result;
+    }
+
+    // Drains a counter-style fd (eventfd, timerfd); false when nothing was pending
+    bool DrainCounter(int fd) {
+        uint64_t value;
+        return read(fd, &value, sizeof(value)) == sizeof(value);
+    }
+}
+
+class EventLoop::Impl {
+public:
+    struct FdWatch {
+        uint32_t events;
+        Callback callback;
+    };
+
+    struct Timer {
+        int fd;
+        Callback callback;
+    };
+
+    int epollFd = -1;
+    int wakeFd = -1;
+    int signalFd = -1;
+    std::map<int, FdWatch> fds;
+    std::vector<Timer> timers;
+    SignalCallback signalCallback;
+
+    std::atomic<bool> stopRequested{false};
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> wakeups{0};
+
+    std::mutex postMutex;
+    std::vector<Callback> posted;
+    std::vector<Callback> dispatching;
+
+    Impl() {
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epollFd < 0 || wakeFd < 0 || !Register(wakeFd, EPOLLIN, PackSource(SourceKind::Wakeup, 0))) {
+            LOG_ERROR("Failed to create event loop: {}", std::strerror(errno));
+        }
+    }
+
+    ~Impl() {
+        for (const auto& timer : timers) {
+            if (timer.fd >= 0) close(timer.fd);
+        }
+        if (signalFd >= 0) close(signalFd);
+        if (wakeFd >= 0) close(wakeFd);
+        if (epollFd >= 0) close(epollFd);
+    }
+
+    bool Register(int fd, uint32_t events, uint64_t data) {
+        epoll_event event{};
+        event.events = events;
+        event.data.u64 = data;
+        return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == 0;
+    }
+
+    void Run() {
+        running.store(true);
+        epoll_event events[16];
+
+        while (!stopRequested.load()) {
+            int count = epoll_wait(epollFd, events, 16, -1);
+            if (count < 0) {
+                if (errno == EINTR) continue;
+                LOG_ERROR("Event loop wait failed: {}", std::strerror(errno));
+                break;
+            }
+            wakeups.fetch_add(1, std::memory_order_relaxed);
+
+            for (int i = 0; i < count && !stopRequested.load(); ++i) {
+                Dispatch(events[i].data.u64);
+            }
+            RunPosted();
+        }
+
+        stopRequested.store(false);
+        running.store(false);
+    }
+
+    void Dispatch(uint64_t data) {
+        auto kind = static_cast<SourceKind>(data >> 32);
+        auto key = static_cast<uint32_t>(data);
+
+        switch (kind) {
+            case SourceKind::Fd: {
+                auto it = fds.find(static_cast<int>(key));
+                if (it == fds.end()) return;  // unwatched earlier in this batch
+                // Copy: the callback may unwatch (and destroy) itself
+                Callback callback = it->second.callback;
+                callback();
+                break;
+            }
+            case SourceKind::Timer: {
+                // Destroyed, re-armed or disarmed earlier in this batch
+                if (key >= timers.size() || timers[key].fd < 0 || !DrainCounter(timers[key].fd)) return;
+                Callback callback = timers[key].callback;
+                callback();
+                break;
+            }
+            case SourceKind::Signal: {
+                signalfd_siginfo info;
+                while (read(signalFd, &info, sizeof(info)) == sizeof(info)) {
+                    if (signalCallback) signalCallback(static_cast<int>(info.ssi_signo));
+                }
+                break;
+            }
+            case SourceKind::Wakeup:
+                DrainCounter(wakeFd);
+                break;
+        }
+    }
+
+    void Wakeup() {
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd, &one, sizeof(one));
+        (void)ignored;
+    }
+
+    void RunPosted() {
+        {
+            std::lock_guard<std::mutex> lock(postMutex);
+            if (posted.empty()) return;
+            dispatching.swap(posted);
+        }
+        for (auto& callback : dispatching) {
+            callback();
+        }
+        dispatching.clear();
+    }
+};
+
+bool EventLoop::SupportsFdWatch() const {
+    return true;
+}
+
+bool EventLoop::WatchFd(int fd, uint32_t events, Callback callback) {
+    if (fd < 0 || pImpl->fds.count(fd)) return false;
+    if (!pImpl->Register(fd, ToEpollEvents(events), PackSource(SourceKind::Fd, static_cast<uint32_t>(fd)))) {
+        return false;
+    }
+    pImpl->fds[fd] = {events, std::move(callback)};
+    return true;
+}
+
+bool EventLoop::ModifyFd(int fd, uint32_t events) {
+    auto it = pImpl->fds.find(fd);
+    if (it == pImpl->fds.end()) return false;
+    if (it->second.events == events) return true;
+
+    epoll_event event{};
+    event.events = ToEpollEvents(events);
+    event.data.u64 = PackSource(SourceKind::Fd, static_cast<uint32_t>(fd));
+    if (epoll_ctl(pImpl->epollFd, EPOLL_CTL_MOD, fd, &event) != 0) {
+        return false;
+    }
+    it->second.events = events;
+    return true;
+}
+
+void EventLoop::UnwatchFd(int fd) {
+    if (pImpl->fds.erase(fd)) {
+        // Fails harmlessly if the fd was already closed
+        epoll_ctl(pImpl->epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    }
+}
+
+EventLoop::TimerId EventLoop::CreateTimer(Callback callback) {
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    TimerId id = 0;
+    while (static_cast<size_t>(id) < pImpl->timers.size() && pImpl->timers[id].fd >= 0) {
+        ++id;
+    }
+    if (fd < 0 || !pImpl->Register(fd, EPOLLIN, PackSource(SourceKind::Timer, static_cast<uint32_t>(id)))) {
+        LOG_ERROR("Failed to create timer: {}", std::strerror(errno));
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    if (static_cast<size_t>(id) == pImpl->timers.size()) {
+        pImpl->timers.push_back({fd, std::move(callback)});
+    } else {
+        pImpl->timers[id] = {fd, std::move(callback)};
+    }
+    return id;
+}
+
+void EventLoop::ArmTimer(TimerId timer, std::chrono::milliseconds delay) {
+    if (timer < 0 || static_cast<size_t>(timer) >= pImpl->timers.size()) return;
+
+    auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(delay).count();
+    if (nanoseconds <= 0) {
+        nanoseconds = 1;  // a zero value would disarm the timer
+    }
+
+    itimerspec spec{};
+    spec.it_value.tv_sec = static_cast<time_t>(nanoseconds / 1000000000);
+    spec.it_value.tv_nsec = static_cast<long>(nanoseconds % 1000000000);
+    timerfd_settime(pImpl->timers[timer].fd, 0, &spec, nullptr);
+}
+
+void EventLoop::DisarmTimer(TimerId timer) {
+    if (timer < 0 || static_cast<size_t>(timer) >= pImpl->timers.size()) return;
+
+    itimerspec spec{};
+    timerfd_settime(pImpl->timers[timer].fd, 0, &spec, nullptr);
+}
+
+void EventLoop::DestroyTimer(TimerId timer) {
+    if (timer < 0 || static_cast<size_t>(timer) >= pImpl->timers.size() || pImpl->timers[timer].fd < 0) return;
+
+    epoll_ctl(pImpl->epollFd, EPOLL_CTL_DEL, pImpl->timers[timer].fd, nullptr);
+    close(pImpl->timers[timer].fd);
+    pImpl->timers[timer] = {-1, nullptr};
+}
+
+bool EventLoop::WatchSignals(std::initializer_list<int> signals, SignalCallback callback) {
+    sigset_t mask;
+    sigemptyset(&mask);
+    for (int signal : signals) {
+        sigaddset(&mask, signal);
+    }
+
+    if (pthread_sigmask(SIG_BLOCK, &mask, nullptr) != 0) {
+        return false;
+    }
+
+    bool created = pImpl->signalFd < 0;
+    pImpl->signalFd = signalfd(pImpl->signalFd, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (pImpl->signalFd < 0) {
+        LOG_ERROR("Failed to create signalfd: {}", std::strerror(errno));
+        return false;
+    }
+    if (created && !pImpl->Register(pImpl->signalFd, EPOLLIN, PackSource(SourceKind::Signal, 0))) {
+        return false;
+    }
+
+    pImpl->signalCallback = std::move(callback);
+    return true;
+}
+
+#else
+
+namespace {
+    // Signals arrive through a plain handler that only records the number.
+    // Locking or notifying from a handler is not async-signal-safe, so a
+    // loop that watches signals polls for it instead; the callback itself
+    // runs on the loop thread.
+    constexpr std::chrono::milliseconds SIGNAL_POLL_INTERVAL{100};
+    std::atomic<int> g_pendingSignal{0};
+
+    extern "C" void RecordSignal(int signal) {
+        g_pendingSignal.store(signal);
+    }
+}
+
+class EventLoop::Impl {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Timer {
+        Callback callback;
+        bool armed = false;
+        Clock::time_point deadline;
+        bool inUse = true;
+    };
+
+    std::vector<Timer> timers;
+    SignalCallback signalCallback;
+
+    std::atomic<bool> stopRequested{false};
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> wakeups{0};
+
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    bool wakePending = false;
+
+    std::mutex postMutex;
+    std::vector<Callback> posted;
+    std::vector<Callback> dispatching;
+
+    void Run() {
+        running.store(true);
+
+        while (!stopRequested.load()) {
+            bool hasDeadline = false;
+            Clock::time_point deadline;
+            for (const auto& timer : timers) {
+                if (timer.armed && (!hasDeadline || timer.deadline < deadline)) {
+                    deadline = timer.deadline;
+                    hasDeadline = true;
+                }
+            }
+
+            if (signalCallback) {
+                auto poll = Clock::now() + SIGNAL_POLL_INTERVAL;
+                if (!hasDeadline || poll < deadline) {
+                    deadline = poll;
+                    hasDeadline = true;
+                }
+            }
+
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                auto woken = [this] { return wakePending || g_pendingSignal.load() != 0; };
+                if (hasDeadline) {
+                    wakeCondition.wait_until(lock, deadline, woken);
+                } else {
+                    wakeCondition.wait(lock, woken);
+                }
+                wakePending = false;
+            }
+            wakeups.fetch_add(1, std::memory_order_relaxed);
+
+            int signal = g_pendingSignal.exchange(0);
+            if (signal != 0 && signalCallback) {
+                signalCallback(signal);
+            }
+
+            auto now = Clock::now();
+            for (size_t i = 0; i < timers.size() && !stopRequested.load(); ++i) {
+                if (timers[i].armed && timers[i].deadline <= now) {
+                    timers[i].armed = false;
+                    Callback callback = timers[i].callback;
+                    callback();
+                }
+            }
+            RunPosted();
+        }
+
+        stopRequested.store(false);
+        running.store(false);
+    }
+
+    void Wakeup() {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        wakePending = true;
+        wakeCondition.notify_one();
+    }
+
+    void RunPosted() {
+        {
+            std::lock_guard<std::mutex> lock(postMutex);
+            if (posted.empty()) return;
+            dispatching.swap(posted);
+        }
+        for (auto& callback : dispatching) {
+            callback();
+        }
+        dispatching.clear();
+    }
+};
+
+bool EventLoop::SupportsFdWatch() const {
+    return false;
+}
+
+bool EventLoop::WatchFd(int, uint32_t, Callback) {
+    return false;
+}
+
+bool EventLoop::ModifyFd(int, uint32_t) {
+    return false;
+}
+
+void EventLoop::UnwatchFd(int) {
+}
+
+EventLoop::TimerId EventLoop::CreateTimer(Callback callback) {
+    for (size_t i = 0; i < pImpl->timers.size(); ++i) {
+        if (!pImpl->timers[i].inUse) {
+            pImpl->timers[i] = {std::move(callback)};
+            return static_cast<TimerId>(i);
+        }
+    }
+    pImpl->timers.push_back({std::move(callback)});
+    return static_cast<TimerId>(pImpl->timers.size() - 1);
+}
+
+void EventLoop::ArmTimer(TimerId timer, std::chrono::milliseconds delay) {
+    if (timer < 0 || static_cast<size_t>(timer) >= pImpl->timers.size() || !pImpl->timers[timer].inUse) return;
+    pImpl->timers[timer].armed = true;
+    pImpl->timers[timer].deadline = Impl::Clock::now() + delay;
+}
+
+void EventLoop::DisarmTimer(TimerId timer) {
+    if (timer < 0 || static_cast<size_t>(timer) >= pImpl->timers.size()) return;
+    pImpl->timers[timer].armed = false;
+}
+
+void EventLoop::DestroyTimer(TimerId timer) {
+    if (timer < 0 || static_cast<size_t>(timer) >= pImpl->timers.size()) return;
+    pImpl->timers[timer] = Impl::Timer();
+    pImpl->timers[timer].inUse = false;
+}
+
+bool EventLoop::WatchSignals(std::initializer_list<int> signals, SignalCallback callback) {
+    pImpl->signalCallback = std::move(callback);
+    for (int signal : signals) {
+        std::signal(signal, RecordSignal);
+    }
+    return true;
+}
+
+#endif
+
+EventLoop::EventLoop()
+    : pImpl(std::make_unique<Impl>()) {
+}
+
+EventLoop::~EventLoop() = default;
+
+void EventLoop::Run() {
+    pImpl->Run();
+}
+
+void EventLoop::Stop() {
+    pImpl->stopRequested.store(true);
+    pImpl->Wakeup();
+}
+
+void EventLoop::Wakeup() {
+    pImpl->Wakeup();
+}
+
+void EventLoop::Post(Callback callback) {
+    {
+        std::lock_guard<std::mutex> lock(pImpl->postMutex);
+        pImpl->posted.push_back(std::move(callback));
+    }
+    pImpl->Wakeup();
+}
+
+bool EventLoop::IsRunning() const {
+    return pImpl->running.load();
+}
+
+uint64_t EventLoop::GetWakeupCount() const {
+    return pImpl->wakeups.load(std::memory_order_relaxed);
+}
\ No newline at end of file
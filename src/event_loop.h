@@ -0,0 +1,65 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+
+// Single-threaded reactor. On Linux every event source - watched fds, timers
+// (timerfd), signals (signalfd) and cross-thread wakeups (eventfd) - sits on
+// one epoll instance, so the daemon sleeps in the kernel until something
+// actually happens. Elsewhere a condition variable drives timers and wakeups,
+// watched signals are picked up within 100 ms, and fd watches are
+// unsupported; callers fall back to timers for those.
+//
+// Everything except Stop(), Wakeup() and Post() must be called on the thread
+// running the loop (or before Run()).
+class EventLoop {
+public:
+    enum Events : uint32_t {
+        Readable = 1 << 0,
+        Writable = 1 << 1
+    };
+
+    using Callback = std::function<void()>;
+    using SignalCallback = std::function<void(int signal)>;
+    using TimerId = int;
+
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    // File descriptors. Hang-ups and errors are reported as Readable so the
+    // owner notices them on its next read.
+    bool SupportsFdWatch() const;
+    bool WatchFd(int fd, uint32_t events, Callback callback);
+    bool ModifyFd(int fd, uint32_t events);
+    void UnwatchFd(int fd);
+
+    // One-shot timers. Arming an armed timer replaces its deadline.
+    // Destroyed timer ids are reused by later CreateTimer() calls.
+    TimerId CreateTimer(Callback callback);
+    void ArmTimer(TimerId timer, std::chrono::milliseconds delay);
+    void DisarmTimer(TimerId timer);
+    void DestroyTimer(TimerId timer);
+
+    // Delivers the given signals through the loop instead of async handlers.
+    // On Linux they are blocked in the calling thread, so call this from the
+    // thread that runs the loop before any other threads are started.
+    bool WatchSignals(std::initializer_list<int> signals, SignalCallback callback);
+
+    void Run();                       // Dispatches events until Stop()
+    void Stop();                      // Thread-safe
+    void Wakeup();                    // Thread-safe
+    void Post(Callback callback);     // Thread-safe, runs on the loop thread
+
+    bool IsRunning() const;
+    uint64_t GetWakeupCount() const;  // Times the loop returned from waiting
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "fl_studio_detector.h"
 #include "process_detector.h"
+#include "detector_recording.h"
+#include "trace.h"
 #include <algorithm>
 #include <regex>
 #include <iostream>
@@ -11,13 +13,34 @@ const std::vector<std::string> FLStudioDetector::FL_PROCESS_NAMES = {
     "FL Studio 20",   // macOS
     "FL Studio",      // Generic macOS
     "fl64.exe",       // Linux/Wine (lowercase)
-    "fl.exe",         // Linux/Wine (lowercase)
-    "wine"            // Linux Wine (check cmdline)
+    "fl.exe"          // Linux/Wine (lowercase)
 };
 
-FLStudioDetector::FLStudioDetector() {
+namespace {
+    // Wine's loader (comm is cut at 15 bytes) only counts when it runs an FL
+    // executable. Added first, so it wins over any name substring.
+    const char* WINE_LOADER_PATTERN = "^wine(64)?(-preload(er)?)?$";
+    constexpr int WINE_LOADER = 0;
+    
+    // Processes that may have a Wine prefix to read
+    bool IsWineProcess(const std::string& name) {
+        bool endsWithExe = name.size() > 4 && (name.compare(name.size() - 4, 4, ".exe") == 0 ||
+                                               name.compare(name.size() - 4, 4, ".EXE") == 0);
+        return endsWithExe || name == "wine";
+    }
+}
+
+FLStudioDetector::FLStudioDetector()
+    : wineRegistry(std::make_shared<WineRegistry>())
+    , pluginScanner(std::make_shared<PluginScanner>())
+    , pluginStage(std::make_shared<EnrichmentPipeline::Stage<PluginScan>>("plugin scan")) {
     lastInfo.sessionStartTime = std::time(nullptr);
     lastUpdate = std::chrono::steady_clock::now();
+    
+    // Window titles are only looked up for FL Studio candidates, not every
+    // process. Without a process source the system is scanned into processTable.
+    windowTitleSource = [](int pid) { return CrossPlatformProcessDetector::GetWindowTitle(pid); };
+    CompileMatchers();
 }
 
 FLStudioInfo FLStudioDetector::GetCurrentInfo() {
@@ -30,10 +53,37 @@ FLStudioInfo FLStudioDetector::GetCurrentInfo() {
         return lastInfo;
     }
     
+    // Tracked-only economy: a liveness probe instead of a process scan. The
+    // start time is checked as in RefreshTracked(), or a reused PID would
+    // keep a closed FL Studio on display.
+    if (trackedOnly && lastInfo.isRunning && trackedChecks < TRACKED_SCAN_EVERY &&
+        trackedProcess.pid > 0 && trackedProcess.pid == lastInfo.processId &&
+        CrossPlatformProcessDetector::GetProcessStartTime(trackedProcess.pid) == trackedStart) {
+        ++trackedChecks;
+        lastInfo.lastActivity = std::time(nullptr);
+        lastUpdate = now;
+        return lastInfo;
+    }
+    trackedChecks = 0;
+    
+    // Steady state: the known instance is verified by PID, not rediscovered
     FLStudioInfo info;
+    if (now - lastDiscovery < DISCOVERY_INTERVAL && RefreshTracked(info, now)) {
+        lastInfo = info;
+        lastUpdate = now;
+        return info;
+    }
+    
+    TRACE_SCOPE("DetectFLStudio");
     auto flProcesses = FindFLStudioProcesses();
+    lastDiscovery = now;
     
     if (flProcesses.empty()) {
+        FinishEnrichment(flProcesses, true);
+        if (recorder) {
+            recorder->RecordCycle(flProcesses);
+        }
+        Track(nullptr);
         info.isRunning = false;
         info.isIdle = true;
         lastInfo = info;
@@ -41,68 +91,385 @@ FLStudioInfo FLStudioDetector::GetCurrentInfo() {
         return info;
     }
     
-    // Use the first (or most relevant) FL Studio process
-    ProcessInfo flProcess = flProcesses[0];
+    // Use the first (or most relevant) FL Studio process. An instance that
+    // is already tracked keeps priority, so discovering a second one does
+    // not restart the session.
+    auto flProcess = std::find_if(flProcesses.begin(), flProcesses.end(),
+                                  [this](const ProcessInfo& process) { return process.pid == trackedProcess.pid; });
+    if (flProcess == flProcesses.end()) {
+        flProcess = flProcesses.begin();
+    }
+    for (const auto& process : flProcesses) {
+        StartEnrichment(process);
+    }
+    StartPluginScan(flProcess->pid, now);
+    FinishEnrichment(flProcesses, true);
+    if (recorder) {
+        recorder->RecordCycle(flProcesses);
+    }
+    
+    Track(&*flProcess);
+    BuildInfo(*flProcess, lastInfo, info);
+    ApplyPluginScan(info);
+    
+    lastInfo = info;
+    lastUpdate = now;
+    
+    return info;
+}
+
+bool FLStudioDetector::RefreshTracked(FLStudioInfo& info, std::chrono::steady_clock::time_point now) {
+    if (trackedProcess.pid <= 0) return false;
+    
+    // A different start time means the PID now belongs to another process
+    if (CrossPlatformProcessDetector::GetProcessStartTime(trackedProcess.pid) != trackedStart) {
+        Track(nullptr);
+        return false;
+    }
+    
+    TRACE_SCOPE("RefreshTrackedProcess");
+    StartEnrichment(trackedProcess);
+    StartPluginScan(trackedProcess.pid, now);
+    std::vector<ProcessInfo> flProcesses{trackedProcess};
+    FinishEnrichment(flProcesses, false);
+    BuildInfo(flProcesses.front(), lastInfo, info);
+    ApplyPluginScan(info);
+    return true;
+}
+
+void FLStudioDetector::Track(const ProcessInfo* flProcess) {
+    trackedProcess = ProcessInfo();
+    trackedStart = 0;
+    
+    // Injected sources have no real PIDs to verify, and a recording needs
+    // every cycle to be a scan
+    if (!flProcess || processSource || recorder) return;
+    
+    trackedStart = CrossPlatformProcessDetector::GetProcessStartTime(flProcess->pid);
+    if (trackedStart == 0) return;
+    trackedProcess.pid = flProcess->pid;
+    trackedProcess.name = flProcess->name;
+    trackedProcess.executablePath = flProcess->executablePath;
+}
+
+void FLStudioDetector::StartEnrichment(const ProcessInfo& flProcess) {
+    auto& instance = stages[flProcess.pid];
+    if (!instance.title) {
+        instance.title = std::make_shared<EnrichmentPipeline::Stage<std::string>>("window title");
+        instance.wineProjects = std::make_shared<EnrichmentPipeline::Stage<std::vector<std::string>>>("wine registry");
+    }
+    int pid = flProcess.pid;
+    
+    // Titles only for the handful of candidates, unless the source had one
+    if (flProcess.windowTitle.empty()) {
+        enrichment.Start(instance.title, TITLE_DEADLINE, [source = windowTitleSource, pid] {
+            TRACE_SCOPE("GetWindowTitle");
+            return source(pid);
+        });
+    }
+    
+    // Registry reads for live processes that may run under Wine, under the
+    // same conditions BuildInfo() applies them
+    if (!processSource && !skipEnrichment && IsWineProcess(flProcess.name)) {
+        enrichment.Start(instance.wineProjects, WINE_DEADLINE, [registry = wineRegistry, pid] {
+            TRACE_SCOPE("ReadWinePrefix");
+            std::vector<std::string> recentProjects;
+            std::lock_guard<std::mutex> lock(registry->mutex);
+            registry->reader.Lookup(pid, recentProjects);
+            return recentProjects;
+        });
+    }
+}
+
+void FLStudioDetector::StartPluginScan(int pid, std::chrono::steady_clock::time_point now) {
+    // Like the Wine registry: live processes only, skipped in economy mode
+    if (processSource || skipEnrichment) return;
+    if (pid == pluginPid && now - lastPluginScan < PLUGIN_SCAN_INTERVAL) return;
+    
+    auto started = enrichment.Start(pluginStage, PLUGIN_DEADLINE, [scanner = pluginScanner, pid] {
+        TRACE_SCOPE("ScanPlugins");
+        PluginScan scan;
+        scan.pid = pid;
+        scan.changed = scanner->Scan(pid);
+        scan.plugins = scanner->GetPlugins();
+        return scan;
+    });
+    if (!started) return;
+    pluginPid = pid;
+    lastPluginScan = now;
+}
+
+void FLStudioDetector::FinishEnrichment(std::vector<ProcessInfo>& flProcesses, bool prune) {
+    {
+        TRACE_SCOPE("WaitForEnrichment");
+        enrichment.Wait();
+    }
+    for (auto& process : flProcesses) {
+        if (process.windowTitle.empty()) {
+            process.windowTitle = stages[process.pid].title->Latest();
+        }
+    }
+    
+    // A full scan saw every candidate; stages of the others are stale
+    if (!prune) return;
+    for (auto instance = stages.begin(); instance != stages.end();) {
+        bool seen = std::any_of(flProcesses.begin(), flProcesses.end(),
+                                [&instance](const ProcessInfo& process) { return process.pid == instance->first; });
+        instance = seen ? std::next(instance) : stages.erase(instance);
+    }
+}
+
+std::vector<FLStudioDetector::UserInstance> FLStudioDetector::GetCurrentInfoByUser() {
+    std::lock_guard<std::mutex> lock(detectionMutex);
     
+    auto now = std::chrono::steady_clock::now();
+    if (std::chrono::duration_cast<std::chrono::milliseconds>(now - lastUpdate) < updateInterval) {
+        return lastInstances;
+    }
+    
+    // One scan covers every user; owners are only looked up for candidates
+    TRACE_SCOPE("DetectFLStudio");
+    auto flProcesses = FindFLStudioProcesses();
+    for (const auto& process : flProcesses) {
+        StartEnrichment(process);
+    }
+    FinishEnrichment(flProcesses, true);
+    if (recorder) {
+        recorder->RecordCycle(flProcesses);
+    }
+    
+    std::vector<UserInstance> instances;
+    for (auto& process : flProcesses) {
+        int uid = CrossPlatformProcessDetector::GetProcessOwner(process.pid);
+        if (uid < 0) continue;
+        
+        // First candidate per user wins, as in GetCurrentInfo()
+        bool known = std::any_of(instances.begin(), instances.end(),
+                                 [uid](const UserInstance& instance) { return instance.uid == uid; });
+        if (known) continue;
+        
+        auto previous = std::find_if(lastInstances.begin(), lastInstances.end(),
+                                     [uid](const UserInstance& instance) { return instance.uid == uid; });
+        UserInstance instance;
+        instance.uid = uid;
+        BuildInfo(process, previous != lastInstances.end() ? previous->info : FLStudioInfo(), instance.info);
+        instances.push_back(std::move(instance));
+    }
+    
+    lastInstances = instances;
+    lastUpdate = now;
+    return instances;
+}
+
+void FLStudioDetector::BuildInfo(ProcessInfo& flProcess, const FLStudioInfo& previous, FLStudioInfo& info) const {
     info.isRunning = true;
     info.processId = flProcess.pid;
-    info.windowTitle = flProcess.windowTitle;
-    info.executablePath = flProcess.executablePath;
+    info.windowTitle = std::move(flProcess.windowTitle);
+    info.executablePath = std::move(flProcess.executablePath);
     
     // Parse information from window title
-    ParseWindowTitle(info.windowTitle, info);
+    {
+        TRACE_SCOPE("ParseWindowTitle");
+        ParseWindowTitle(info.windowTitle, info);
+    }
+    
+    // Wine keeps the recent-project list in the prefix's registry. Only live
+    // processes have a prefix to look at; replayed ones do not. Economy mode
+    // keeps what was read for this process before.
+    if (skipEnrichment && previous.processId == info.processId) {
+        info.recentProjects = previous.recentProjects;
+        if (info.projectName.empty() && info.windowTitle.empty()) {
+            info.projectName = previous.projectName;
+        }
+        if (info.projectName == previous.projectName) {
+            info.projectPath = previous.projectPath;
+        }
+    } else if (!processSource && !skipEnrichment) {
+        ApplyWineProjects(flProcess, info);
+    }
+    
+    if (previous.processId == info.processId) {
+        info.plugins = previous.plugins;
+    }
     
     // Detect FL Studio version
     DetectVersion(flProcess.name, info.windowTitle, info);
     
     // Reset session start time if this is a new process
-    if (lastInfo.processId != info.processId) {
+    if (previous.processId != info.processId) {
         info.sessionStartTime = std::time(nullptr);
     } else {
-        info.sessionStartTime = lastInfo.sessionStartTime;
+        info.sessionStartTime = previous.sessionStartTime;
     }
     
     info.lastActivity = std::time(nullptr);
+}
+
+void FLStudioDetector::ApplyWineProjects(const ProcessInfo& flProcess, FLStudioInfo& info) const {
+    auto instance = stages.find(flProcess.pid);
+    if (instance == stages.end()) return;
+    info.recentProjects = instance->second.wineProjects->Latest();
     
+    // The title names the open project; the registry knows where it lives.
+    // Without any title the most recently used project is the best guess.
+    for (const auto& path : info.recentProjects) {
+        size_t nameStart = path.find_last_of('/') + 1;
+        std::string name = path.substr(nameStart, path.size() - nameStart - 4);
+        if (info.projectName.empty() && info.windowTitle.empty()) {
+            info.projectName = name;
+        }
+        if (name == info.projectName) {
+            info.projectPath = path;
+            break;
+        }
+    }
+}
+
+void FLStudioDetector::ApplyPluginScan(FLStudioInfo& info) {
+    // A scan that finished late still counts if it was of this process
+    PluginScan scan;
+    if (!pluginStage->TakeNewer(pluginScansSeen, scan)) return;
+    if (scan.changed && scan.pid == info.processId) {
+        info.plugins = std::move(scan.plugins);
+    }
+}
+
+void FLStudioDetector::Restore(const FLStudioInfo& info) {
+    std::lock_guard<std::mutex> lock(detectionMutex);
     lastInfo = info;
-    lastUpdate = now;
-    
-    return info;
+    lastInfo.lastActivity = std::time(nullptr);
+    lastUpdate = std::chrono::steady_clock::now();
 }
 
 bool FLStudioDetector::IsFLStudioRunning() const {
+    std::lock_guard<std::mutex> lock(detectionMutex);
     return !FindFLStudioProcesses().empty();
 }
 
+void FLStudioDetector::RequestRefresh() {
+    std::lock_guard<std::mutex> lock(detectionMutex);
+    lastUpdate = std::chrono::steady_clock::time_point();
+}
+
 void FLStudioDetector::SetUpdateInterval(std::chrono::milliseconds interval) {
     std::lock_guard<std::mutex> lock(detectionMutex);
     updateInterval = interval;
 }
 
+void FLStudioDetector::SetProcessSource(ProcessSource source) {
+    std::lock_guard<std::mutex> lock(detectionMutex);
+    processSource = std::move(source);
+    Track(nullptr);
+}
+
+void FLStudioDetector::SetWindowTitleSource(WindowTitleSource source) {
+    std::lock_guard<std::mutex> lock(detectionMutex);
+    windowTitleSource = std::move(source);
+    enrichment.SetInline(true);
+}
+
+void FLStudioDetector::SetRecorder(DetectorRecorder* recorder) {
+    std::lock_guard<std::mutex> lock(detectionMutex);
+    this->recorder = recorder;
+    Track(nullptr);
+}
+
+void FLStudioDetector::SetExtraProcessNames(const std::vector<std::string>& names) {
+    std::lock_guard<std::mutex> lock(detectionMutex);
+    if (names == extraProcessNames) return;
+    extraProcessNames = names;
+    CompileMatchers();
+}
+
+void FLStudioDetector::SetEconomy(bool skipEnrichment, bool trackedOnly) {
+    std::lock_guard<std::mutex> lock(detectionMutex);
+    this->skipEnrichment = skipEnrichment;
+    this->trackedOnly = trackedOnly;
+}
+
+void FLStudioDetector::CompileMatchers() {
+    std::string error;
+    nameMatcher = PatternAutomaton();
+    nameMatcher.AddRegex(WINE_LOADER_PATTERN, error);
+    for (const auto& flName : FL_PROCESS_NAMES) {
+        nameMatcher.AddSubstring(flName);
+    }
+    for (const auto& flName : extraProcessNames) {
+        if (!flName.empty()) nameMatcher.AddSubstring(flName);
+    }
+    nameMatcher.Build();
+    
+    winePathMatcher = PatternAutomaton();
+    winePathMatcher.AddSubstring("fl");
+    winePathMatcher.Build();
+    
+    titleMatcher = PatternAutomaton();
+    titleMatcher.AddSubstring("FL Studio");
+    titleMatcher.Build();
+    
+    // Cached verdicts came from the old patterns
+    nameVerdicts.clear();
+}
+
+FLStudioDetector::NameVerdict FLStudioDetector::ClassifyName(std::string_view name) const {
+    int pattern = nameMatcher.Find(name);
+    if (pattern < 0) return NameVerdict::NoMatch;
+    
+    // Wine processes need their executable path checked as well
+    return pattern == WINE_LOADER ? NameVerdict::Wine : NameVerdict::Match;
+}
+
+bool FLStudioDetector::IsFLWinePath(std::string_view path) const {
+    return winePathMatcher.Matches(path);
+}
+
 std::vector<ProcessInfo> FLStudioDetector::FindFLStudioProcesses() const {
     std::vector<ProcessInfo> flProcesses;
-    auto allProcesses = CrossPlatformProcessDetector::GetAllProcesses();
-    
-    for (const auto& process : allProcesses) {
-        // Check if process name matches any FL Studio variants
-        for (const auto& flName : FL_PROCESS_NAMES) {
-            if (process.name.find(flName) != std::string::npos) {
-                // Additional validation for Wine processes
-                if (process.name == "wine") {
-                    if (process.executablePath.find("FL") != std::string::npos ||
-                        process.executablePath.find("fl") != std::string::npos) {
-                        flProcesses.push_back(process);
-                    }
-                } else {
-                    flProcesses.push_back(process);
-                }
-                break;
+    
+    if (processSource) {
+        std::vector<ProcessInfo> allProcesses;
+        {
+            TRACE_SCOPE("GetAllProcesses");
+            allProcesses = processSource();
+        }
+        
+        for (auto& process : allProcesses) {
+            NameVerdict verdict = ClassifyName(process.name);
+            
+            // Also check window titles for macOS (when the source already provides them)
+            if (verdict == NameVerdict::Match ||
+                (verdict == NameVerdict::Wine && IsFLWinePath(process.executablePath)) ||
+                titleMatcher.Matches(process.windowTitle)) {
+                flProcesses.push_back(std::move(process));
             }
         }
+    } else {
+        {
+            TRACE_SCOPE("GetAllProcesses");
+            CrossPlatformProcessDetector::ScanProcesses(processTable);
+        }
         
-        // Also check window titles for macOS
-        if (process.windowTitle.find("FL Studio") != std::string::npos) {
-            flProcesses.push_back(process);
+        // Interned names repeat from scan to scan, so each distinct name is
+        // classified once and later scans are a lookup per row
+        if (verdictGeneration != processTable.GetGeneration()) {
+            nameVerdicts.clear();
+            verdictGeneration = processTable.GetGeneration();
+        }
+        if (nameVerdicts.size() < processTable.GetStringCount()) {
+            nameVerdicts.resize(processTable.GetStringCount(), NameVerdict::Unknown);
+        }
+        
+        const auto& nameIds = processTable.GetNameIds();
+        const auto& pathIds = processTable.GetPathIds();
+        for (size_t row = 0; row < nameIds.size(); ++row) {
+            NameVerdict& verdict = nameVerdicts[nameIds[row]];
+            if (verdict == NameVerdict::Unknown) {
+                verdict = ClassifyName(processTable.GetString(nameIds[row]));
+            }
+            if (verdict == NameVerdict::Match ||
+                (verdict == NameVerdict::Wine && IsFLWinePath(processTable.GetString(pathIds[row])))) {
+                flProcesses.push_back(processTable.ToProcessInfo(row));
+            }
         }
     }
     
@@ -133,8 +500,9 @@ void FLStudioDetector::ParseWindowTitle(const std::string& title, FLStudioInfo&
         return;
     }
     
-    // Try to extract project name from various other formats
-    std::regex projectRegex(R"(([^-—]+\.flp)\s*\*?)");
+    // Try to extract project name from various other formats. Compiled once:
+    // building the regex costs about a thousand allocations.
+    static const std::regex projectRegex(R"(([^-—]+\.flp)\s*\*?)");
     std::smatch match;
     if (std::regex_search(title, match, projectRegex)) {
         ExtractProjectName(match[1].str(), info);
@@ -144,16 +512,17 @@ void FLStudioDetector::ParseWindowTitle(const std::string& title, FLStudioInfo&
 void FLStudioDetector::ExtractProjectName(const std::string& projectPart, FLStudioInfo& info) const {
     std::string cleaned = projectPart;
     
+    // Remove unsaved indicator (*) first, so "Song.flp *" and "Song.flp"
+    // name the same project
+    while (!cleaned.empty() && (cleaned.back() == '*' || cleaned.back() == ' ')) {
+        cleaned.pop_back();
+    }
+    
     // Remove .flp extension
     if (cleaned.length() > 4 && cleaned.substr(cleaned.length() - 4) == ".flp") {
         cleaned = cleaned.substr(0, cleaned.length() - 4);
     }
     
-    // Remove unsaved indicator (*)
-    while (!cleaned.empty() && (cleaned.back() == '*' || cleaned.back() == ' ')) {
-        cleaned.pop_back();
-    }
-    
     // Trim whitespace
     cleaned.erase(0, cleaned.find_first_not_of(" \t\r\n"));
     cleaned.erase(cleaned.find_last_not_of(" \t\r\n") + 1);
@@ -2,22 +2,86 @@
 
 #include <mutex>
 #include <chrono>
+#include <functional>
 #include "../include/fl_studio_types.h"
+#include "enrichment_pipeline.h"
+#include "pattern_automaton.h"
+#include "plugin_scanner.h"
+#include "process_table.h"
+#include "wine_prefix.h"
+#include <memory>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
+class DetectorRecorder;
+
 class FLStudioDetector {
 public:
+    // Where process lists and window titles come from. Defaults to the real
+    // system; tests and benchmarks inject fakes to run headless. An empty
+    // process source means the built-in scan into a reusable ProcessTable.
+    using ProcessSource = std::function<std::vector<ProcessInfo>()>;
+    using WindowTitleSource = std::function<std::string(int pid)>;
+    
     FLStudioDetector();
     ~FLStudioDetector() = default;
     
+    // FL Studio instance owned by one user (multi-user server mode)
+    struct UserInstance {
+        int uid = -1;
+        FLStudioInfo info;
+    };
+    
     FLStudioInfo GetCurrentInfo();
+    // One scan, grouped by the owning user's UID. Users without a running
+    // instance are absent. Linux only; elsewhere owners are unknown.
+    std::vector<UserInstance> GetCurrentInfoByUser();
     bool IsFLStudioRunning() const;
+    // Seeds the cached state with a session restored from a snapshot. The
+    // next GetCurrentInfo() returns it without scanning; the first real scan
+    // comes one interval later and keeps the session start if the PID matches.
+    void Restore(const FLStudioInfo& info);
+    
+    // Makes the next GetCurrentInfo() look at the system again even if the
+    // update interval has not passed
+    void RequestRefresh();
     
     // Configuration
     void SetUpdateInterval(std::chrono::milliseconds interval);
+    void SetProcessSource(ProcessSource source);
+    void SetWindowTitleSource(WindowTitleSource source);
+    // Captures each scan's candidates for later replay (nullptr stops)
+    void SetRecorder(DetectorRecorder* recorder);
+    // Additional process names (matched anywhere in the name, any case) on
+    // top of the built-in FL Studio names
+    void SetExtraProcessNames(const std::vector<std::string>& names);
+    // Cheaper detection for a tight CPU budget. Without enrichment the Wine
+    // registry is not consulted. Tracked-only cycles just confirm the last
+    // FL Studio PID is alive and keep the last info, refreshing its title
+    // every few cycles and scanning whenever the process is gone.
+    void SetEconomy(bool skipEnrichment, bool trackedOnly);
     
 private:
+    enum NameVerdict : uint8_t {
+        Unknown,
+        NoMatch,
+        Match,
+        Wine      // Needs the executable path checked
+    };
+    
+    void CompileMatchers();
+    NameVerdict ClassifyName(std::string_view name) const;
+    bool IsFLWinePath(std::string_view path) const;
     std::vector<ProcessInfo> FindFLStudioProcesses() const;
+    bool RefreshTracked(FLStudioInfo& info, std::chrono::steady_clock::time_point now);
+    void Track(const ProcessInfo* flProcess);
+    void StartEnrichment(const ProcessInfo& flProcess);
+    void StartPluginScan(int pid, std::chrono::steady_clock::time_point now);
+    void FinishEnrichment(std::vector<ProcessInfo>& flProcesses, bool prune);
+    void BuildInfo(ProcessInfo& flProcess, const FLStudioInfo& previous, FLStudioInfo& info) const;
+    void ApplyWineProjects(const ProcessInfo& flProcess, FLStudioInfo& info) const;
+    void ApplyPluginScan(FLStudioInfo& info);
     void ParseWindowTitle(const std::string& title, FLStudioInfo& info) const;
     void ExtractProjectName(const std::string& projectPart, FLStudioInfo& info) const;
     void DetectVersion(const std::string& processName, const std::string& title, FLStudioInfo& info) const;
@@ -25,9 +89,73 @@ private:
     
     mutable std::mutex detectionMutex;
     std::chrono::milliseconds updateInterval{2000};
+    ProcessSource processSource;
+    WindowTitleSource windowTitleSource;
+    DetectorRecorder* recorder = nullptr;
+    
+    // Economy settings
+    static constexpr int TRACKED_SCAN_EVERY = 8;
+    bool skipEnrichment = false;
+    bool trackedOnly = false;
+    int trackedChecks = 0;
+    
+    // Once found, FL Studio is followed by PID: a cycle verifies its start
+    // time and re-reads its title, independent of how many processes the
+    // host runs. Discovery scans for other instances run far less often.
+    static constexpr std::chrono::seconds DISCOVERY_INTERVAL{30};
+    ProcessInfo trackedProcess;     // Without window title; pid 0 if none
+    uint64_t trackedStart = 0;
+    std::chrono::steady_clock::time_point lastDiscovery;
+    
+    // Every candidate pattern compiled into one automaton per field, so a
+    // name, path or title is classified in a single pass
+    std::vector<std::string> extraProcessNames;
+    PatternAutomaton nameMatcher;
+    PatternAutomaton winePathMatcher;
+    PatternAutomaton titleMatcher;
+    
+    // System scans: reused table plus a per-name-id verdict cache
+    mutable ProcessTable processTable;
+    mutable std::vector<NameVerdict> nameVerdicts;
+    mutable uint64_t verdictGeneration = 0;
+    
+    // Per-candidate enrichment runs as concurrent stages, so a hung helper
+    // (xdotool, wmctrl) costs at most its deadline and then its last value
+    static constexpr std::chrono::milliseconds TITLE_DEADLINE{300};
+    static constexpr std::chrono::milliseconds WINE_DEADLINE{200};
+    static constexpr std::chrono::milliseconds PLUGIN_DEADLINE{200};
+    struct InstanceStages {
+        std::shared_ptr<EnrichmentPipeline::Stage<std::string>> title;
+        std::shared_ptr<EnrichmentPipeline::Stage<std::vector<std::string>>> wineProjects;
+    };
+    EnrichmentPipeline enrichment;
+    std::unordered_map<int, InstanceStages> stages;     // By PID
+    
+    // Project paths from Wine prefixes' registries; shared by the stages of
+    // every instance
+    struct WineRegistry {
+        std::mutex mutex;
+        WinePrefixReader reader;
+    };
+    std::shared_ptr<WineRegistry> wineRegistry;
+    
+    // Loaded plugins change rarely and the maps file of a big session runs
+    // to tens of thousands of lines, so it is re-read on a slow cadence
+    static constexpr std::chrono::seconds PLUGIN_SCAN_INTERVAL{15};
+    struct PluginScan {
+        int pid = 0;
+        bool changed = false;
+        std::vector<std::string> plugins;
+    };
+    std::shared_ptr<PluginScanner> pluginScanner;
+    std::shared_ptr<EnrichmentPipeline::Stage<PluginScan>> pluginStage;
+    uint64_t pluginScansSeen = 0;
+    int pluginPid = 0;
+    std::chrono::steady_clock::time_point lastPluginScan;
     
     // Cached state
     FLStudioInfo lastInfo;
+    std::vector<UserInstance> lastInstances;
     std::chrono::steady_clock::time_point lastUpdate;
     
     // FL Studio process names for different platforms
@@ -0,0 +1,137 @@
+/* flrpc_state_reader.c - reader side of flrpc_state.h */
+#include "flrpc_state.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+/* A writer holds the sequence odd for a ~1 KB copy; this many attempts only
+ * run out if it publishes continuously */
+#define MAX_READ_ATTEMPTS 1000
+
+#if defined(_MSC_VER)
+    static uint64_t load_acquire(const volatile uint64_t* value) {
+        uint64_t result = *value;
+        MemoryBarrier();
+        return result;
+    }
+    static void fence_acquire(void) { MemoryBarrier(); }
+    static void cpu_relax(void) { YieldProcessor(); }
+#else
+    static uint64_t load_acquire(const volatile uint64_t* value) {
+        return __atomic_load_n((const uint64_t*)value, __ATOMIC_ACQUIRE);
+    }
+    static void fence_acquire(void) { __atomic_thread_fence(__ATOMIC_ACQUIRE); }
+    static void cpu_relax(void) {
+    #if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+    #endif
+    }
+#endif
+
+int flrpc_state_default_name(char* buffer, size_t size) {
+#ifdef _WIN32
+    int written = snprintf(buffer, size, "%s", FLRPC_STATE_WINDOWS_NAME);
+#else
+    int written = snprintf(buffer, size, "%s%u", FLRPC_STATE_NAME_PREFIX, (unsigned)getuid());
+#endif
+    return written > 0 && (size_t)written < size ? 0 : -1;
+}
+
+int flrpc_state_open(flrpc_state_reader* reader, const char* name) {
+    char defaultName[64];
+    const volatile flrpc_state* shared;
+
+    reader->shared = NULL;
+    reader->handle = NULL;
+    if (!name) {
+        if (flrpc_state_default_name(defaultName, sizeof(defaultName)) != 0) return FLRPC_STATE_UNAVAILABLE;
+        name = defaultName;
+    }
+
+#ifdef _WIN32
+    {
+        HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name);
+        void* view;
+        if (!mapping) return FLRPC_STATE_UNAVAILABLE;
+        view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, sizeof(flrpc_state));
+        if (!view) {
+            CloseHandle(mapping);
+            return FLRPC_STATE_UNAVAILABLE;
+        }
+        shared = (const volatile flrpc_state*)view;
+        reader->handle = mapping;
+    }
+#else
+    {
+        struct stat status;
+        void* view;
+        int fd = shm_open(name, O_RDONLY, 0);
+        if (fd < 0) return FLRPC_STATE_UNAVAILABLE;
+        if (fstat(fd, &status) != 0 || (size_t)status.st_size < sizeof(flrpc_state)) {
+            close(fd);
+            return FLRPC_STATE_UNAVAILABLE;
+        }
+        view = mmap(NULL, sizeof(flrpc_state), PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (view == MAP_FAILED) return FLRPC_STATE_UNAVAILABLE;
+        shared = (const volatile flrpc_state*)view;
+    }
+#endif
+
+    /* The writer sets magic last, once the header is complete */
+    reader->shared = shared;
+    if (shared->magic != FLRPC_STATE_MAGIC || shared->version != FLRPC_STATE_VERSION ||
+        shared->size < sizeof(flrpc_state)) {
+        flrpc_state_close(reader);
+        return FLRPC_STATE_UNAVAILABLE;
+    }
+    return FLRPC_STATE_OK;
+}
+
+int flrpc_state_read(const flrpc_state_reader* reader, flrpc_state* out) {
+    int attempt;
+    if (!reader || !reader->shared) return FLRPC_STATE_UNAVAILABLE;
+
+    for (attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt) {
+        uint64_t before = load_acquire(&reader->shared->sequence);
+        uint64_t after;
+        if (before & 1) {
+            cpu_relax();
+            continue;
+        }
+
+        /* May race with the writer; the sequence check below throws such a copy away */
+        memcpy(out, (const void*)reader->shared, sizeof(*out));
+        fence_acquire();
+        after = reader->shared->sequence;
+        if (before == after) {
+            out->sequence = before;
+            return FLRPC_STATE_OK;
+        }
+    }
+    return FLRPC_STATE_BUSY;
+}
+
+uint64_t flrpc_state_sequence(const flrpc_state_reader* reader) {
+    return reader && reader->shared ? load_acquire(&reader->shared->sequence) : 0;
+}
+
+void flrpc_state_close(flrpc_state_reader* reader) {
+    if (!reader || !reader->shared) return;
+#ifdef _WIN32
+    UnmapViewOfFile((LPCVOID)reader->shared);
+    CloseHandle((HANDLE)reader->handle);
+#else
+    munmap((void*)reader->shared, sizeof(flrpc_state));
+#endif
+    reader->shared = NULL;
+    reader->handle = NULL;
+}
\ No newline at end of file
@@ -0,0 +1,210 @@
+#include "json_writer.h"
+#include <charconv>
+
+namespace {
+    const char HEX_DIGITS[] = "0123456789abcdef";
+
+    // Length of the valid UTF-8 sequence starting at data[0], or 0 if invalid
+    // (overlong forms, surrogates and code points above U+10FFFF are rejected)
+    size_t ValidUtf8Length(const unsigned char* data, size_t available) {
+        unsigned char lead = data[0];
+        size_t length;
+        uint32_t minimum;
+        uint32_t codePoint;
+
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            length = 2; minimum = 0x80; codePoint = lead & 0x1F;
+        } else if (lead >= 0xE0 && lead <= 0xEF) {
+            length = 3; minimum = 0x800; codePoint = lead & 0x0F;
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            length = 4; minimum = 0x10000; codePoint = lead & 0x07;
+        } else {
+            return 0;
+        }
+
+        if (available < length) {
+            return 0;
+        }
+        for (size_t i = 1; i < length; ++i) {
+            if ((data[i] & 0xC0) != 0x80) {
+                return 0;
+            }
+            codePoint = (codePoint << 6) | (data[i] & 0x3F);
+        }
+
+        if (codePoint < minimum || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+            return 0;
+        }
+        return length;
+    }
+}
+
+JsonWriter::JsonWriter(size_t initialCapacity) {
+    buffer.reserve(initialCapacity);
+    Reset();
+}
+
+void JsonWriter::Reset() {
+    buffer.clear();
+    depth = 0;
+    afterKey = false;
+}
+
+void JsonWriter::BeforeValue() {
+    if (afterKey) {
+        afterKey = false;
+        return;
+    }
+    if (depth > 0) {
+        if (hasElements[depth - 1]) {
+            buffer += ',';
+        }
+        hasElements[depth - 1] = true;
+    }
+}
+
+void JsonWriter::BeginObject() {
+    BeforeValue();
+    buffer += '{';
+    if (depth < MAX_DEPTH) {
+        hasElements[depth++] = false;
+    }
+}
+
+void JsonWriter::EndObject() {
+    buffer += '}';
+    if (depth > 0) --depth;
+}
+
+void JsonWriter::BeginArray() {
+    BeforeValue();
+    buffer += '[';
+    if (depth < MAX_DEPTH) {
+        hasElements[depth++] = false;
+    }
+}
+
+void JsonWriter::EndArray() {
+    buffer += ']';
+    if (depth > 0) --depth;
+}
+
+void JsonWriter::Key(std::string_view key) {
+    BeforeValue();
+    WriteEscaped(key);
+    buffer += ':';
+    afterKey = true;
+}
+
+void JsonWriter::String(std::string_view value) {
+    BeforeValue();
+    WriteEscaped(value);
+}
+
+void JsonWriter::Int(int64_t value) {
+    BeforeValue();
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer.append(digits, result.ptr);
+}
+
+void JsonWriter::UInt(uint64_t value) {
+    BeforeValue();
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer.append(digits, result.ptr);
+}
+
+void JsonWriter::Fixed(int64_t scaled, int decimals) {
+    BeforeValue();
+    if (scaled < 0) {
+        buffer += '-';
+    }
+    uint64_t magnitude = scaled < 0 ? 0 - static_cast<uint64_t>(scaled) : static_cast<uint64_t>(scaled);
+    uint64_t divisor = 1;
+    for (int i = 0; i < decimals; ++i) {
+        divisor *= 10;
+    }
+
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), magnitude / divisor);
+    buffer.append(digits, result.ptr);
+    if (decimals > 0) {
+        result = std::to_chars(digits, digits + sizeof(digits), magnitude % divisor + divisor);
+        buffer += '.';
+        buffer.append(digits + 1, result.ptr);  // skip the leading 1 that kept the zero padding
+    }
+}
+
+void JsonWriter::Bool(bool value) {
+    BeforeValue();
+    buffer += value ? "true" : "false";
+}
+
+void JsonWriter::Null() {
+    BeforeValue();
+    buffer += "null";
+}
+
+void JsonWriter::WriteEscaped(std::string_view value) {
+    const auto* data = reinterpret_cast<const unsigned char*>(value.data());
+    const size_t size = value.size();
+
+    buffer += '"';
+
+    size_t runStart = 0;
+    size_t i = 0;
+    while (i < size) {
+        unsigned char c = data[i];
+
+        // Fast path: printable ASCII that needs no escaping is copied in runs
+        if (c >= 0x20 && c < 0x7F && c != '"' && c != '\\') {
+            ++i;
+            continue;
+        }
+
+        bool lineSeparator = false;
+        if (c >= 0x80) {
+            size_t length = ValidUtf8Length(data + i, size - i);
+            if (length > 0) {
+                // U+2028/U+2029 are valid JSON but break JavaScript consumers
+                lineSeparator = length == 3 && c == 0xE2 && data[i + 1] == 0x80 &&
+                                (data[i + 2] == 0xA8 || data[i + 2] == 0xA9);
+                if (!lineSeparator) {
+                    i += length;
+                    continue;
+                }
+            }
+        }
+
+        buffer.append(value.data() + runStart, i - runStart);
+
+        switch (c) {
+            case '"':  buffer += "\\\""; ++i; break;
+            case '\\': buffer += "\\\\"; ++i; break;
+            case '\b': buffer += "\\b"; ++i; break;
+            case '\f': buffer += "\\f"; ++i; break;
+            case '\n': buffer += "\\n"; ++i; break;
+            case '\r': buffer += "\\r"; ++i; break;
+            case '\t': buffer += "\\t"; ++i; break;
+            default:
+                if (c < 0x80) {
+                    // Remaining control characters and DEL
+                    char escaped[6] = {'\\', 'u', '0', '0', HEX_DIGITS[c >> 4], HEX_DIGITS[c & 0x0F]};
+                    buffer.append(escaped, sizeof(escaped));
+                    ++i;
+                } else if (lineSeparator) {
+                    buffer += data[i + 2] == 0xA8 ? "\\u2028" : "\\u2029";
+                    i += 3;
+                } else {
+                    buffer += "\\ufffd";
+                    ++i;
+                }
+                break;
+        }
+        runStart = i;
+    }
+
+    buffer.append(value.data() + runStart, size - runStart);
+    buffer += '"';
+}
\ No newline at end of file
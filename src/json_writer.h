@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Streaming JSON writer for the small, fixed-shape payloads we send to
+// Discord. Output goes into a buffer that is reused across Reset() calls, so
+// once it has grown to the largest payload no further allocations happen.
+// Strings are escaped per RFC 8259; invalid UTF-8 becomes U+FFFD.
+class JsonWriter {
+public:
+    explicit JsonWriter(size_t initialCapacity = 1024);
+
+    void Reset();
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+
+    void Key(std::string_view key);
+    void String(std::string_view value);
+    void Int(int64_t value);
+    void UInt(uint64_t value);
+    void Fixed(int64_t scaled, int decimals);  // scaled / 10^decimals, exact
+    void Bool(bool value);
+    void Null();
+
+    std::string_view View() const { return buffer; }
+    size_t Capacity() const { return buffer.capacity(); }
+
+private:
+    static constexpr int MAX_DEPTH = 32;
+
+    void BeforeValue();
+    void WriteEscaped(std::string_view value);
+
+    std::string buffer;
+    // Per nesting level: has the container received its first element yet
+    bool hasElements[MAX_DEPTH];
+    int depth = 0;
+    bool afterKey = false;
+};
\ No newline at end of file
@@ -0,0 +1,389 @@
+#include "logger.h"
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <thread>
+
+#ifndef _WIN32
+#include <csignal>
+#include <pthread.h>
+#endif
+
+std::atomic<uint8_t> Logger::minimumLevel{static_cast<uint8_t>(LogLevel::Info)};
+
+namespace {
+    const char* LevelName(LogLevel level) {
+        switch (level) {
+            case LogLevel::Debug: return "DEBUG";
+            case LogLevel::Info: return "INFO ";
+            case LogLevel::Warning: return "WARN ";
+            case LogLevel::Error: return "ERROR";
+            case LogLevel::Off: break;
+        }
+        return "?    ";
+    }
+}
+
+// Consumer side: owns the thread, the sinks and all formatting state
+class Logger::Backend {
+public:
+    Options options;
+    std::mutex optionsMutex;
+
+    std::thread thread;
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    bool stopRequested = false;
+
+    std::FILE* file = nullptr;
+    size_t fileBytes = 0;
+    std::string openFilePath;
+
+    // Wall-clock time of steady clock zero, for timestamps
+    int64_t wallOffset = 0;
+
+    std::string line;
+    std::string consoleOut;
+    std::string consoleErr;
+    std::string fileOut;
+    uint64_t reportedDrops = 0;
+
+    Backend() {
+        line.reserve(512);
+        auto wall = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        wallOffset = wall - Now();
+    }
+
+    ~Backend() {
+        if (file) std::fclose(file);
+    }
+
+    static int64_t Now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void AppendArg(const Record& record, const Arg& arg) {
+        char number[32];
+        switch (arg.type) {
+            case ArgType::Int:
+                std::snprintf(number, sizeof(number), "%lld", static_cast<long long>(arg.i));
+                line += number;
+                break;
+            case ArgType::UInt:
+                std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(arg.u));
+                line += number;
+                break;
+            case ArgType::Double:
+                // Durations and sizes: about three significant digits, never exponents
+                std::snprintf(number, sizeof(number), "%.*f",
+                              arg.d >= 100 || arg.d <= -100 ? 0 : (arg.d >= 10 || arg.d <= -10 ? 1 : 2), arg.d);
+                line += number;
+                break;
+            case ArgType::Bool:
+                line += arg.u ? "true" : "false";
+                break;
+            case ArgType::Text:
+                line.append(record.text + arg.text.offset, arg.text.length);
+                break;
+        }
+    }
+
+    void Format(const Record& record) {
+        line.clear();
+
+        std::time_t seconds = static_cast<std::time_t>((record.timestamp + wallOffset) / 1000000000);
+        int millis = static_cast<int>(((record.timestamp + wallOffset) / 1000000) % 1000);
+        std::tm local{};
+#ifdef _WIN32
+        localtime_s(&local, &seconds);
+#else
+        localtime_r(&seconds, &local);
+#endif
+        char prefix[48];
+        std::strftime(prefix, sizeof(prefix), "%Y-%m-%d %H:%M:%S", &local);
+        line += prefix;
+        std::snprintf(prefix, sizeof(prefix), ".%03d %s ", millis, LevelName(record.level));
+        line += prefix;
+
+        size_t argIndex = 0;
+        for (const char* cursor = record.format; *cursor; ++cursor) {
+            if (cursor[0] == '{' && cursor[1] == '}') {
+                if (argIndex < record.argCount) {
+                    AppendArg(record, record.args[argIndex++]);
+                }
+                ++cursor;
+            } else {
+                line += *cursor;
+            }
+        }
+
+        if (record.suppressed > 0) {
+            line += " (";
+            line += std::to_string(record.suppressed);
+            line += " similar messages suppressed)";
+        }
+        line += '\n';
+    }
+
+    void OpenFile(const Options& current) {
+        if (file) {
+            std::fclose(file);
+            file = nullptr;
+        }
+        openFilePath = current.filePath;
+        if (openFilePath.empty()) return;
+
+        file = std::fopen(openFilePath.c_str(), "a");
+        if (!file) {
+            std::fprintf(stderr, "Cannot open log file %s\n", openFilePath.c_str());
+            return;
+        }
+        std::fseek(file, 0, SEEK_END);
+        long position = std::ftell(file);
+        fileBytes = position > 0 ? static_cast<size_t>(position) : 0;
+    }
+
+    // path -> path.1 -> ... -> path.N (oldest dropped)
+    void Rotate(const Options& current) {
+        std::fclose(file);
+        file = nullptr;
+
+        for (int i = current.maxFiles; i >= 1; --i) {
+            std::string from = i == 1 ? current.filePath : current.filePath + "." + std::to_string(i - 1);
+            std::string to = current.filePath + "." + std::to_string(i);
+            std::remove(to.c_str());
+            std::rename(from.c_str(), to.c_str());
+        }
+        OpenFile(current);
+    }
+
+    void WriteBatch(const Options& current) {
+        if (!consoleOut.empty()) {
+            std::fwrite(consoleOut.data(), 1, consoleOut.size(), stdout);
+            std::fflush(stdout);
+            consoleOut.clear();
+        }
+        if (!consoleErr.empty()) {
+            std::fwrite(consoleErr.data(), 1, consoleErr.size(), stderr);
+            std::fflush(stderr);
+            consoleErr.clear();
+        }
+        if (!fileOut.empty() && file) {
+            if (current.maxFileBytes > 0 && fileBytes + fileOut.size() > current.maxFileBytes && fileBytes > 0) {
+                Rotate(current);
+            }
+            if (file) {
+                std::fwrite(fileOut.data(), 1, fileOut.size(), file);
+                std::fflush(file);
+                fileBytes += fileOut.size();
+            }
+        }
+        fileOut.clear();
+    }
+};
+
+Logger& Logger::Instance() {
+    static Logger instance;
+    return instance;
+}
+
+Logger::Logger()
+    : backend(new Backend())
+    , rateLimitWindow(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::seconds(10)).count())
+    , rateLimitBurst(10)
+    , slots(new Slot[RING_SLOTS]) {
+    for (size_t i = 0; i < RING_SLOTS; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+Logger::~Logger() {
+    Shutdown();
+    delete backend;
+    delete[] slots;
+}
+
+void Logger::Configure(const Options& options) {
+    {
+        std::lock_guard<std::mutex> lock(backend->optionsMutex);
+        backend->options = options;
+    }
+    minimumLevel.store(static_cast<uint8_t>(options.minimumLevel));
+    rateLimitBurst.store(options.rateLimitBurst);
+    rateLimitWindow.store(std::chrono::duration_cast<std::chrono::nanoseconds>(options.rateLimitWindow).count());
+
+    std::lock_guard<std::mutex> lock(backend->wakeMutex);
+    if (backend->thread.joinable()) {
+        backend->wakeCondition.notify_one();
+        return;
+    }
+
+    backend->stopRequested = false;
+    backend->thread = std::thread([this] {
+#ifndef _WIN32
+        // Signals belong to the event loop's signalfd, never to this thread
+        sigset_t all;
+        sigfillset(&all);
+        pthread_sigmask(SIG_BLOCK, &all, nullptr);
+#endif
+        Options current;
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(backend->optionsMutex);
+                current = backend->options;
+            }
+            if (current.filePath != backend->openFilePath) {
+                backend->OpenFile(current);
+            }
+
+            // Drain everything published so far
+            uint64_t position = dequeuePosition.load(std::memory_order_relaxed);
+            while (true) {
+                Slot& slot = slots[position & (RING_SLOTS - 1)];
+                if (slot.sequence.load(std::memory_order_acquire) != position + 1) break;
+
+                backend->Format(slot.record);
+                bool isError = slot.record.level >= LogLevel::Warning;
+                if (current.console) {
+                    (isError ? backend->consoleErr : backend->consoleOut) += backend->line;
+                }
+                if (backend->file) {
+                    backend->fileOut += backend->line;
+                }
+
+                slot.sequence.store(position + RING_SLOTS, std::memory_order_release);
+                ++position;
+                dequeuePosition.store(position, std::memory_order_relaxed);
+            }
+
+            uint64_t drops = dropped.load(std::memory_order_relaxed);
+            if (drops != backend->reportedDrops) {
+                std::string notice = "Logger: " + std::to_string(drops - backend->reportedDrops) +
+                                     " records dropped (ring buffer full)\n";
+                backend->consoleErr += notice;
+                backend->reportedDrops = drops;
+            }
+            backend->WriteBatch(current);
+
+            // Sleep until a producer publishes; producers only notify when we
+            // sleep. The fence pairs with Publish(): either it sees the flag
+            // or we see its record, never neither.
+            std::unique_lock<std::mutex> lock(backend->wakeMutex);
+            consumerSleeping.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            Slot& next = slots[position & (RING_SLOTS - 1)];
+            if (next.sequence.load(std::memory_order_acquire) == position + 1) {
+                consumerSleeping.store(false);
+                continue;
+            }
+            if (backend->stopRequested) {
+                consumerSleeping.store(false);
+                break;
+            }
+            backend->wakeCondition.wait(lock);
+            consumerSleeping.store(false);
+        }
+    });
+}
+
+void Logger::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(backend->wakeMutex);
+        if (!backend->thread.joinable()) return;
+        backend->stopRequested = true;
+        backend->wakeCondition.notify_one();
+    }
+    backend->thread.join();
+}
+
+bool Logger::Admit(LogSite& site, int64_t now, uint32_t& suppressedBefore) {
+    int64_t window = rateLimitWindow.load(std::memory_order_relaxed);
+    int64_t start = site.windowStart.load(std::memory_order_relaxed);
+
+    if (now - start >= window && site.windowStart.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+        site.windowCount.store(0, std::memory_order_relaxed);
+    }
+
+    if (site.windowCount.fetch_add(1, std::memory_order_relaxed) >= rateLimitBurst.load(std::memory_order_relaxed)) {
+        site.suppressed.fetch_add(1, std::memory_order_relaxed);
+        suppressedTotal.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    suppressedBefore = site.suppressed.exchange(0, std::memory_order_relaxed);
+    return true;
+}
+
+void Logger::WriteLines(LogSite& site, std::string_view text) {
+    int64_t now = Now();
+    uint32_t suppressedBefore = 0;
+    if (!Admit(site, now, suppressedBefore)) {
+        return;
+    }
+
+    while (!text.empty()) {
+        size_t end = text.find('\n');
+        std::string_view line = text.substr(0, end);
+        if (!line.empty()) {
+            Enqueue(site.level, now, suppressedBefore, "  {}", line);
+            suppressedBefore = 0;
+        }
+        if (end == std::string_view::npos) break;
+        text.remove_prefix(end + 1);
+    }
+}
+
+// Bounded MPSC ring (Vyukov): a slot is free for position p when its
+// sequence equals p, and readable when it equals p + 1
+Logger::Slot* Logger::Claim() {
+    uint64_t position = enqueuePosition.load(std::memory_order_relaxed);
+    while (true) {
+        Slot& slot = slots[position & (RING_SLOTS - 1)];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        int64_t difference = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+
+        if (difference == 0) {
+            if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                return &slot;
+            }
+        } else if (difference < 0) {
+            return nullptr;  // full
+        } else {
+            position = enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void Logger::Publish(Slot* slot) {
+    uint64_t position = slot->sequence.load(std::memory_order_relaxed);
+    slot->sequence.store(position + 1, std::memory_order_release);
+
+    // Keeps the store above from passing the load below; see the consumer
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (consumerSleeping.load()) {
+        std::lock_guard<std::mutex> lock(backend->wakeMutex);
+        backend->wakeCondition.notify_one();
+    }
+}
+
+void Logger::EncodeText(Record& record, const char* data, size_t length) {
+    Arg& arg = record.args[record.argCount++];
+    arg.type = ArgType::Text;
+
+    size_t available = TEXT_BYTES - record.textUsed;
+    if (length > available) {
+        length = available;
+        // Keep multi-byte characters whole
+        while (length > 0 && (static_cast<unsigned char>(data[length]) & 0xC0) == 0x80) {
+            --length;
+        }
+    }
+
+    std::memcpy(record.text + record.textUsed, data, length);
+    arg.text.offset = record.textUsed;
+    arg.text.length = static_cast<uint16_t>(length);
+    record.textUsed = static_cast<uint16_t>(record.textUsed + length);
+}
\ No newline at end of file
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+enum class LogLevel : uint8_t {
+    Debug,
+    Info,
+    Warning,
+    Error,
+    Off
+};
+
+// One per LOG_* call site. Carries the per-site rate limit state so repeated
+// messages ("Failed to update Discord presence") collapse into a count.
+struct LogSite {
+    LogLevel level;
+    std::atomic<int64_t> windowStart{0};
+    std::atomic<uint32_t> windowCount{0};
+    std::atomic<uint32_t> suppressed{0};
+
+    explicit LogSite(LogLevel level) : level(level) {}
+};
+
+// Structured asynchronous logger. LOG_* calls copy the format pointer and
+// raw arguments into a fixed-size record in a lock-free ring buffer; a
+// background thread does all formatting and I/O (console and an optional
+// size-rotated file), flushing once per batch. The hot path costs one clock
+// read, a CAS and a few stores. When the ring is full records are dropped
+// and counted rather than blocking the caller.
+//
+// Formats use {} placeholders: LOG_INFO("Connected via {}", path)
+class Logger {
+public:
+    static constexpr size_t MAX_ARGS = 6;
+    static constexpr size_t TEXT_BYTES = 184;   // inline storage for string arguments
+    static constexpr size_t RING_SLOTS = 4096;  // power of two
+
+    struct Options {
+        LogLevel minimumLevel = LogLevel::Info;
+        bool console = true;
+        std::string filePath;            // empty: no file
+        size_t maxFileBytes = 1024 * 1024;
+        int maxFiles = 3;                // rotated copies kept: path.1 .. path.N
+        uint32_t rateLimitBurst = 10;    // records per site per window
+        std::chrono::seconds rateLimitWindow{10};
+    };
+
+    static Logger& Instance();
+
+    // Starts the background thread on first call; later calls reconfigure
+    void Configure(const Options& options);
+    // Drains everything queued so far and stops the background thread
+    void Shutdown();
+
+    static bool IsEnabled(LogLevel level) {
+        return static_cast<uint8_t>(level) >= minimumLevel.load(std::memory_order_relaxed);
+    }
+
+    template <typename... Args>
+    void Write(LogSite& site, const char* format, const Args&... args);
+    // Each line of a multi-line message (e.g. a list of config errors) as its
+    // own indented record; rate limited as a single message
+    void WriteLines(LogSite& site, std::string_view text);
+
+    uint64_t GetDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+    uint64_t GetSuppressedCount() const { return suppressedTotal.load(std::memory_order_relaxed); }
+
+private:
+    enum class ArgType : uint8_t { Int, UInt, Double, Bool, Text };
+
+    struct Arg {
+        ArgType type;
+        union {
+            int64_t i;
+            uint64_t u;
+            double d;
+            struct {
+                uint16_t offset;
+                uint16_t length;
+            } text;
+        };
+    };
+
+    struct Record {
+        int64_t timestamp;        // steady clock, nanoseconds
+        const char* format;
+        LogLevel level;
+        uint8_t argCount;
+        uint16_t textUsed;
+        uint32_t suppressed;      // similar records dropped by the rate limit before this one
+        Arg args[MAX_ARGS];
+        char text[TEXT_BYTES];
+    };
+
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        Record record;
+    };
+
+    Logger();
+    ~Logger();
+
+    static int64_t Now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool Admit(LogSite& site, int64_t now, uint32_t& suppressedBefore);
+    template <typename... Args>
+    void Enqueue(LogLevel level, int64_t now, uint32_t suppressed, const char* format, const Args&... args);
+    Slot* Claim();
+    void Publish(Slot* slot);
+
+    template <typename T>
+    static void Encode(Record& record, const T& value);
+    static void EncodeText(Record& record, const char* data, size_t length);
+
+    class Backend;
+    Backend* backend;
+
+    static std::atomic<uint8_t> minimumLevel;
+    std::atomic<int64_t> rateLimitWindow;
+    std::atomic<uint32_t> rateLimitBurst;
+
+    Slot* slots;
+    alignas(64) std::atomic<uint64_t> enqueuePosition{0};
+    alignas(64) std::atomic<uint64_t> dequeuePosition{0};
+    std::atomic<bool> consumerSleeping{false};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> suppressedTotal{0};
+};
+
+template <typename T>
+void Logger::Encode(Record& record, const T& value) {
+    Arg& arg = record.args[record.argCount++];
+    if constexpr (std::is_same_v<T, bool>) {
+        arg.type = ArgType::Bool;
+        arg.u = value ? 1 : 0;
+    } else if constexpr (std::is_enum_v<T>) {
+        arg.type = ArgType::Int;
+        arg.i = static_cast<int64_t>(value);
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        arg.type = ArgType::Int;
+        arg.i = value;
+    } else if constexpr (std::is_integral_v<T>) {
+        arg.type = ArgType::UInt;
+        arg.u = value;
+    } else if constexpr (std::is_floating_point_v<T>) {
+        arg.type = ArgType::Double;
+        arg.d = value;
+    } else {
+        static_assert(std::is_convertible_v<const T&, std::string_view>, "unsupported log argument type");
+        std::string_view view(value);
+        --record.argCount;
+        EncodeText(record, view.data(), view.size());
+    }
+}
+
+template <typename... Args>
+void Logger::Write(LogSite& site, const char* format, const Args&... args) {
+    static_assert(sizeof...(Args) <= MAX_ARGS, "too many log arguments");
+
+    int64_t now = Now();
+    uint32_t suppressedBefore = 0;
+    if (Admit(site, now, suppressedBefore)) {
+        Enqueue(site.level, now, suppressedBefore, format, args...);
+    }
+}
+
+template <typename... Args>
+void Logger::Enqueue(LogLevel level, int64_t now, uint32_t suppressed, const char* format, const Args&... args) {
+    Slot* slot = Claim();
+    if (!slot) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Record& record = slot->record;
+    record.timestamp = now;
+    record.format = format;
+    record.level = level;
+    record.argCount = 0;
+    record.textUsed = 0;
+    record.suppressed = suppressed;
+    (Encode(record, args), ...);
+
+    Publish(slot);
+}
+
+#define FLRPC_LOG(severity, ...)                                    \
+    do {                                                            \
+        if (Logger::IsEnabled(severity)) {                          \
+            static LogSite flrpcLogSite(severity);                  \
+            Logger::Instance().Write(flrpcLogSite, __VA_ARGS__);    \
+        }                                                           \
+    } while (0)
+
+#define FLRPC_LOG_LINES(severity, text)                             \
+    do {                                                            \
+        if (Logger::IsEnabled(severity)) {                          \
+            static LogSite flrpcLogSite(severity);                  \
+            Logger::Instance().WriteLines(flrpcLogSite, text);      \
+        }                                                           \
+    } while (0)
+
+#define LOG_DEBUG(...) FLRPC_LOG(LogLevel::Debug, __VA_ARGS__)
+#define LOG_INFO(...) FLRPC_LOG(LogLevel::Info, __VA_ARGS__)
+#define LOG_WARNING(...) FLRPC_LOG(LogLevel::Warning, __VA_ARGS__)
+#define LOG_ERROR(...) FLRPC_LOG(LogLevel::Error, __VA_ARGS__)
+#define LOG_WARNING_LINES(text) FLRPC_LOG_LINES(LogLevel::Warning, text)
\ No newline at end of file
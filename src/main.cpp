@@ -1,74 +1,117 @@
-#include <iostream>
-#include <signal.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <memory>
+#include <string>
 
 #include "discord_client.h"
 #include "config.h"
-
-// Global app instance for signal handling
-std::unique_ptr<FLStudioDiscordApp> g_app = nullptr;
-
-void SignalHandler(int signal) {
-    std::cout << "\nReceived signal " << signal << ", shutting down gracefully..." << std::endl;
-    if (g_app) {
-        g_app->Stop();
-    }
-    exit(0);
-}
+#include "logger.h"
+#include "trace.h"
+#include "resource_usage.h"
 
 int main(int argc, char* argv[]) {
-    std::cout << "FL Studio Discord Rich Presence v1.0.0" << std::endl;
-    std::cout << "Cross-platform FL Studio activity tracking for Discord" << std::endl;
-    std::cout << "==========================================================" << std::endl;
+    auto startTime = std::chrono::steady_clock::now();
+    
+    // Console output until the config decides on levels and the log file
+    Logger::Instance().Configure(Logger::Options());
+    
+    LOG_INFO("FL Studio Discord Rich Presence v1.0.0");
+    LOG_INFO("Cross-platform FL Studio activity tracking for Discord");
     
-    // Set up signal handling for graceful shutdown
-    signal(SIGINT, SignalHandler);   // Ctrl+C
-    signal(SIGTERM, SignalHandler);  // Termination request
-#ifdef _WIN32
-    signal(SIGBREAK, SignalHandler); // Ctrl+Break on Windows
-#endif
+    // Opt-in span tracing, written on SIGUSR1 and at exit
+    if (const char* tracePath = std::getenv("FLRPC_TRACE")) {
+        Tracer::Start(tracePath);
+    }
+    
+    // --record <file>: capture detector input; --replay <file>: feed it back
+    // instead of the live system (--replay-speed recorded|max, default max).
+    // --multi-user: serve every user on a shared machine (run privileged).
+    std::string recordPath;
+    std::string replayPath;
+    bool replayRealTime = false;
+    bool multiUser = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--replay-speed") == 0 && i + 1 < argc) {
+            replayRealTime = std::strcmp(argv[++i], "recorded") == 0;
+        } else if (std::strcmp(argv[i], "--multi-user") == 0) {
+            multiUser = true;
+        } else {
+            LOG_ERROR("usage: {} [--multi-user] [--record FILE] [--replay FILE [--replay-speed recorded|max]]", argv[0]);
+            Logger::Instance().Shutdown();
+            return 1;
+        }
+    }
     
+    int exitCode = 0;
     try {
         // Load configuration
-        std::cout << "Loading configuration..." << std::endl;
+        LOG_INFO("Loading configuration...");
         auto config = AppConfig::Load();
         
         if (!config.IsValid()) {
-            std::cerr << "ERROR: Invalid configuration!" << std::endl;
-            std::cerr << "Please set your Discord Application ID in the config file." << std::endl;
-            std::cerr << "1. Go to https://discord.com/developers/applications" << std::endl;
-            std::cerr << "2. Create a new application" << std::endl;
-            std::cerr << "3. Copy the Application ID" << std::endl;
-            std::cerr << "4. Update the config file with your Application ID" << std::endl;
+            LOG_ERROR("Invalid configuration!");
+            LOG_ERROR("Please set your Discord Application ID in the config file.");
+            LOG_ERROR("1. Go to https://discord.com/developers/applications");
+            LOG_ERROR("2. Create a new application");
+            LOG_ERROR("3. Copy the Application ID");
+            LOG_ERROR("4. Update the config file with your Application ID");
+            Logger::Instance().Shutdown();
             return 1;
         }
         
         // Create and initialize the application
-        g_app = std::make_unique<FLStudioDiscordApp>(config.applicationId);
+        auto app = std::make_unique<FLStudioDiscordApp>(config.applicationId);
         
         // Configure the app
-        g_app->SetUpdateInterval(config.updateInterval);
-        g_app->SetShowProjectName(config.showProjectName);
-        g_app->SetShowBPM(config.showBPM);
+        app->ApplyConfig(config);
+        app->WatchConfigFile(AppConfig::ResolvePath());
+        app->EnableWarmStart(AppConfig::GetSessionSnapshotPath());
+        if (multiUser) {
+            app->EnableMultiUser();
+        }
         
-        if (!g_app->Initialize()) {
-            std::cerr << "ERROR: Failed to initialize FL Studio Discord Rich Presence" << std::endl;
-            std::cerr << "Make sure Discord is running and try again." << std::endl;
+        if (!replayPath.empty() && !app->StartReplay(replayPath, replayRealTime)) {
+            Logger::Instance().Shutdown();
+            return 1;
+        }
+        if (!recordPath.empty() && !app->StartRecording(recordPath)) {
+            Logger::Instance().Shutdown();
             return 1;
         }
         
-        std::cout << "Initialization successful!" << std::endl;
-        std::cout << "Press Ctrl+C to exit" << std::endl;
-        std::cout << "------------------------------------------" << std::endl;
+        if (!app->Initialize()) {
+            LOG_ERROR("Failed to initialize FL Studio Discord Rich Presence");
+            Logger::Instance().Shutdown();
+            return 1;
+        }
         
-        // Run the application (this blocks until shutdown)
-        g_app->Run();
+        char rss[32];
+        auto startupMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        LOG_INFO("Initialization successful! ({} ms, RSS {})", startupMs,
+                 FormatBytes(GetResidentSetBytes(), rss, sizeof(rss)));
+        LOG_INFO("Press Ctrl+C to exit");
+        
+        // Run the application (blocks until SIGINT/SIGTERM)
+        app->Run();
+        
+        if (Tracer::IsEnabled()) {
+            Tracer::Dump();
+        }
         
     } catch (const std::exception& e) {
-        std::cerr << "FATAL ERROR: " << e.what() << std::endl;
-        return 1;
+        LOG_ERROR("FATAL ERROR: {}", e.what());
+        exitCode = 1;
     }
     
-    std::cout << "FL Studio Discord Rich Presence stopped cleanly." << std::endl;
-    return 0;
+    if (exitCode == 0) {
+        LOG_INFO("FL Studio Discord Rich Presence stopped cleanly.");
+    }
+    // Drain queued records before exit
+    Logger::Instance().Shutdown();
+    return exitCode;
 }
\ No newline at end of file
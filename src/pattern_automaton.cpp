@@ -0,0 +1,523 @@
+#include "pattern_automaton.h"
+#include <algorithm>
+#include <cctype>
+
+namespace {
+    // Subset construction is done up front for this many DFA states; anything
+    // beyond is built on first use so pathological rule sets still load quickly
+    constexpr size_t EAGER_STATE_BUDGET = 4096;
+    // Lazily built states are dropped again once there are this many in all
+    constexpr size_t MAX_CACHED_STATES = 4 * EAGER_STATE_BUDGET;
+
+    unsigned char Fold(unsigned char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c - 'A' + 'a') : c;
+    }
+
+    std::vector<bool> MakeSet(bool value = false) {
+        return std::vector<bool>(256, value);
+    }
+
+    std::vector<bool> SingleChar(unsigned char c) {
+        auto set = MakeSet();
+        set[c] = true;
+        return set;
+    }
+
+    void AddEscapeClass(char escape, std::vector<bool>& set) {
+        for (int c = 0; c < 256; ++c) {
+            bool member = false;
+            switch (escape) {
+                case 'd': member = std::isdigit(c) != 0; break;
+                case 'w': member = std::isalnum(c) != 0 || c == '_'; break;
+                case 's': member = std::isspace(c) != 0; break;
+            }
+            if (member) set[c] = true;
+        }
+    }
+
+    // Parses a [...] class starting just after '['. Returns false on error.
+    bool ParseClass(const std::string& pattern, size_t& pos, bool globSyntax, std::vector<bool>& set, std::string& error) {
+        set = MakeSet();
+        bool negate = false;
+        if (pos < pattern.size() && (pattern[pos] == '^' || (globSyntax && pattern[pos] == '!'))) {
+            negate = true;
+            ++pos;
+        }
+
+        bool first = true;
+        while (pos < pattern.size() && (pattern[pos] != ']' || first)) {
+            first = false;
+            unsigned char low = static_cast<unsigned char>(pattern[pos]);
+
+            if (low == '\\' && !globSyntax && pos + 1 < pattern.size()) {
+                char escape = pattern[pos + 1];
+                pos += 2;
+                if (escape == 'd' || escape == 'w' || escape == 's') {
+                    AddEscapeClass(escape, set);
+                    continue;
+                }
+                low = static_cast<unsigned char>(escape);
+            } else {
+                ++pos;
+            }
+
+            unsigned char high = low;
+            if (pos + 1 < pattern.size() && pattern[pos] == '-' && pattern[pos + 1] != ']') {
+                high = static_cast<unsigned char>(pattern[pos + 1]);
+                pos += 2;
+                if (high < low) {
+                    error = "invalid range in character class";
+                    return false;
+                }
+            }
+            for (int c = low; c <= high; ++c) {
+                set[c] = true;
+            }
+        }
+
+        if (pos >= pattern.size()) {
+            error = "unterminated character class";
+            return false;
+        }
+        ++pos; // skip ']'
+
+        if (negate) {
+            set.flip();
+        }
+        return true;
+    }
+}
+
+class PatternAutomaton::RegexParser {
+public:
+    RegexParser(PatternAutomaton& automaton, const std::string& pattern, size_t begin, size_t end)
+        : automaton(automaton), pattern(pattern), pos(begin), end(end) {}
+
+    bool Parse(Fragment& out, std::string& error) {
+        if (!ParseAlternation(out, error)) {
+            return false;
+        }
+        if (pos != end) {
+            error = "unexpected ')' at position " + std::to_string(pos);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    bool ParseAlternation(Fragment& out, std::string& error) {
+        if (!ParseConcatenation(out, error)) return false;
+        while (pos < end && pattern[pos] == '|') {
+            ++pos;
+            Fragment right;
+            if (!ParseConcatenation(right, error)) return false;
+            out = automaton.Alternate(out, right);
+        }
+        return true;
+    }
+
+    bool ParseConcatenation(Fragment& out, std::string& error) {
+        out = automaton.Empty();
+        while (pos < end && pattern[pos] != '|' && pattern[pos] != ')') {
+            Fragment item;
+            if (!ParseRepetition(item, error)) return false;
+            out = automaton.Concat(out, item);
+        }
+        return true;
+    }
+
+    bool ParseRepetition(Fragment& out, std::string& error) {
+        if (!ParseAtom(out, error)) return false;
+        while (pos < end) {
+            char op = pattern[pos];
+            if (op == '*') out = automaton.Star(out);
+            else if (op == '+') out = automaton.Plus(out);
+            else if (op == '?') out = automaton.Optional(out);
+            else break;
+            ++pos;
+        }
+        return true;
+    }
+
+    bool ParseAtom(Fragment& out, std::string& error) {
+        char c = pattern[pos];
+        switch (c) {
+            case '(': {
+                ++pos;
+                if (!ParseAlternation(out, error)) return false;
+                if (pos >= end || pattern[pos] != ')') {
+                    error = "missing ')'";
+                    return false;
+                }
+                ++pos;
+                return true;
+            }
+            case '.':
+                ++pos;
+                out = automaton.Literal(MakeSet(true));
+                return true;
+            case '[': {
+                ++pos;
+                std::vector<bool> set;
+                if (!ParseClass(pattern, pos, false, set, error)) return false;
+                out = automaton.Literal(set);
+                return true;
+            }
+            case '\\': {
+                if (pos + 1 >= end) {
+                    error = "trailing backslash";
+                    return false;
+                }
+                char escape = pattern[pos + 1];
+                pos += 2;
+                if (escape == 'd' || escape == 'w' || escape == 's') {
+                    auto set = MakeSet();
+                    AddEscapeClass(escape, set);
+                    out = automaton.Literal(set);
+                } else {
+                    out = automaton.Literal(SingleChar(static_cast<unsigned char>(escape)));
+                }
+                return true;
+            }
+            case '*':
+            case '+':
+            case '?':
+                error = std::string("nothing to repeat before '") + c + "'";
+                return false;
+            case '^':
+            case '$':
+                error = "anchors are only supported at the start/end of a pattern";
+                return false;
+            default:
+                ++pos;
+                out = automaton.Literal(SingleChar(static_cast<unsigned char>(c)));
+                return true;
+        }
+    }
+
+    PatternAutomaton& automaton;
+    const std::string& pattern;
+    size_t pos;
+    size_t end;
+};
+
+PatternAutomaton::PatternAutomaton() {
+    nfaStart = NewState();
+    std::fill(std::begin(byteClass), std::end(byteClass), 0);
+}
+
+int PatternAutomaton::NewState() {
+    nfa.emplace_back();
+    return static_cast<int>(nfa.size() - 1);
+}
+
+int PatternAutomaton::AddCharSet(const CharSet& set) {
+    // Input is folded to lowercase before matching, so fold the set the same way
+    CharSet folded = MakeSet();
+    for (int c = 0; c < 256; ++c) {
+        if (set[c]) folded[Fold(static_cast<unsigned char>(c))] = true;
+    }
+
+    auto existing = std::find(charSets.begin(), charSets.end(), folded);
+    if (existing != charSets.end()) {
+        return static_cast<int>(existing - charSets.begin());
+    }
+    charSets.push_back(std::move(folded));
+    return static_cast<int>(charSets.size() - 1);
+}
+
+PatternAutomaton::Fragment PatternAutomaton::Literal(const CharSet& set) {
+    int start = NewState();
+    int end = NewState();
+    nfa[start].charSet = AddCharSet(set);
+    nfa[start].next = end;
+    return {start, end};
+}
+
+PatternAutomaton::Fragment PatternAutomaton::Empty() {
+    int state = NewState();
+    return {state, state};
+}
+
+PatternAutomaton::Fragment PatternAutomaton::Concat(Fragment a, Fragment b) {
+    nfa[a.end].epsilon.push_back(b.start);
+    return {a.start, b.end};
+}
+
+PatternAutomaton::Fragment PatternAutomaton::Alternate(Fragment a, Fragment b) {
+    int start = NewState();
+    int end = NewState();
+    nfa[start].epsilon = {a.start, b.start};
+    nfa[a.end].epsilon.push_back(end);
+    nfa[b.end].epsilon.push_back(end);
+    return {start, end};
+}
+
+PatternAutomaton::Fragment PatternAutomaton::Star(Fragment a) {
+    int start = NewState();
+    int end = NewState();
+    nfa[start].epsilon = {a.start, end};
+    nfa[a.end].epsilon.push_back(a.start);
+    nfa[a.end].epsilon.push_back(end);
+    return {start, end};
+}
+
+PatternAutomaton::Fragment PatternAutomaton::Plus(Fragment a) {
+    int end = NewState();
+    nfa[a.end].epsilon.push_back(a.start);
+    nfa[a.end].epsilon.push_back(end);
+    return {a.start, end};
+}
+
+PatternAutomaton::Fragment PatternAutomaton::Optional(Fragment a) {
+    int start = NewState();
+    int end = NewState();
+    nfa[start].epsilon = {a.start, end};
+    nfa[a.end].epsilon.push_back(end);
+    return {start, end};
+}
+
+void PatternAutomaton::AddPattern(Fragment fragment, bool sticky) {
+    nfa[fragment.end].pattern = static_cast<int>(patternCount);
+    stickyPatterns.push_back(sticky);
+    nfa[nfaStart].epsilon.push_back(fragment.start);
+    ++patternCount;
+    built = false;
+}
+
+bool PatternAutomaton::AddGlob(const std::string& pattern, std::string& error) {
+    // Build into a scratch fragment first so a bad pattern leaves no trace
+    size_t rollback = nfa.size();
+    Fragment result = Empty();
+
+    size_t pos = 0;
+    while (pos < pattern.size()) {
+        char c = pattern[pos];
+        Fragment item;
+        if (c == '*') {
+            ++pos;
+            item = Star(Literal(MakeSet(true)));
+        } else if (c == '?') {
+            ++pos;
+            item = Literal(MakeSet(true));
+        } else if (c == '[') {
+            ++pos;
+            CharSet set;
+            if (!ParseClass(pattern, pos, true, set, error)) {
+                nfa.resize(rollback);
+                return false;
+            }
+            item = Literal(set);
+        } else {
+            ++pos;
+            item = Literal(SingleChar(static_cast<unsigned char>(c)));
+        }
+        result = Concat(result, item);
+    }
+
+    AddPattern(result);
+    return true;
+}
+
+bool PatternAutomaton::AddRegex(const std::string& pattern, std::string& error) {
+    size_t begin = 0;
+    size_t end = pattern.size();
+    bool anchoredStart = false;
+    bool anchoredEnd = false;
+
+    if (begin < end && pattern[begin] == '^') {
+        anchoredStart = true;
+        ++begin;
+    }
+    if (end > begin && pattern[end - 1] == '$' && (end < 2 || pattern[end - 2] != '\\')) {
+        anchoredEnd = true;
+        --end;
+    }
+
+    size_t rollback = nfa.size();
+    Fragment body;
+    RegexParser parser(*this, pattern, begin, end);
+    if (!parser.Parse(body, error)) {
+        nfa.resize(rollback);
+        return false;
+    }
+
+    if (!anchoredStart) {
+        body = Concat(Star(Literal(MakeSet(true))), body);
+    }
+    if (!anchoredEnd) {
+        body = Concat(body, Star(Literal(MakeSet(true))));
+    }
+
+    AddPattern(body);
+    return true;
+}
+
+void PatternAutomaton::AddPrefix(const std::string& prefix) {
+    Fragment result = Empty();
+    for (char c : prefix) {
+        result = Concat(result, Literal(SingleChar(static_cast<unsigned char>(c))));
+    }
+    result = Concat(result, Star(Literal(MakeSet(true))));
+    AddPattern(result);
+}
+
+void PatternAutomaton::AddSubstring(const std::string& text) {
+    Fragment result = Star(Literal(MakeSet(true)));
+    for (char c : text) {
+        result = Concat(result, Literal(SingleChar(static_cast<unsigned char>(c))));
+    }
+    AddPattern(result, true);
+}
+
+void PatternAutomaton::Closure(std::vector<int>& states) const {
+    std::vector<bool> seen(nfa.size(), false);
+    std::vector<int> stack(states.begin(), states.end());
+    states.clear();
+
+    while (!stack.empty()) {
+        int state = stack.back();
+        stack.pop_back();
+        if (seen[state]) continue;
+        seen[state] = true;
+        states.push_back(state);
+        for (int next : nfa[state].epsilon) {
+            if (!seen[next]) stack.push_back(next);
+        }
+    }
+
+    std::sort(states.begin(), states.end());
+}
+
+int PatternAutomaton::InternDfaState(std::vector<int> states) const {
+    auto existing = dfaIndex.find(states);
+    if (existing != dfaIndex.end()) {
+        return existing->second;
+    }
+
+    int match = -1;
+    int sticky = -1;
+    for (int state : states) {
+        int pattern = nfa[state].pattern;
+        if (pattern < 0) continue;
+        if (match < 0 || pattern < match) match = pattern;
+        if (stickyPatterns[pattern] && (sticky < 0 || pattern < sticky)) sticky = pattern;
+    }
+
+    int id = static_cast<int>(dfaStates.size());
+    dfaIndex.emplace(states, id);
+    dfaStates.push_back(std::move(states));
+    dfaMatch.push_back(match);
+    dfaSticky.push_back(sticky);
+    transitions.resize(dfaStates.size() * classCount, -1);
+    return id;
+}
+
+int PatternAutomaton::ComputeTransition(int dfaState, int byteClassId) const {
+    unsigned char representative = classRepresentative[byteClassId];
+
+    std::vector<int> next;
+    for (int state : dfaStates[dfaState]) {
+        const NfaState& node = nfa[state];
+        if (node.charSet >= 0 && charSets[node.charSet][representative]) {
+            next.push_back(node.next);
+        }
+    }
+    Closure(next);
+
+    // The source state may be one of the flushed ones; only its target is
+    // still needed
+    if (built && dfaStates.size() >= MAX_CACHED_STATES) {
+        FlushLazyStates();
+    }
+    bool sourceKept = static_cast<size_t>(dfaState) < dfaStates.size();
+
+    int target = InternDfaState(std::move(next));
+    if (sourceKept) {
+        transitions[dfaState * classCount + byteClassId] = target;
+    }
+    return target;
+}
+
+void PatternAutomaton::FlushLazyStates() const {
+    int firstLazy = static_cast<int>(eagerStateCount);
+    for (auto entry = dfaIndex.begin(); entry != dfaIndex.end();) {
+        entry = entry->second >= firstLazy ? dfaIndex.erase(entry) : std::next(entry);
+    }
+    dfaStates.resize(eagerStateCount);
+    dfaMatch.resize(eagerStateCount);
+    dfaSticky.resize(eagerStateCount);
+    transitions.resize(eagerStateCount * classCount);
+    for (int& target : transitions) {
+        if (target >= firstLazy) target = -1;
+    }
+}
+
+void PatternAutomaton::Build() {
+    // Partition bytes into classes that every char set treats identically
+    std::map<std::vector<bool>, int> signatures;
+    classRepresentative.clear();
+    for (int c = 0; c < 256; ++c) {
+        unsigned char folded = Fold(static_cast<unsigned char>(c));
+        std::vector<bool> signature(charSets.size());
+        for (size_t i = 0; i < charSets.size(); ++i) {
+            signature[i] = charSets[i][folded];
+        }
+        auto inserted = signatures.emplace(std::move(signature), static_cast<int>(classRepresentative.size()));
+        if (inserted.second) {
+            classRepresentative.push_back(folded);
+        }
+        byteClass[c] = static_cast<uint8_t>(inserted.first->second);
+    }
+    classCount = static_cast<int>(classRepresentative.size());
+
+    dfaStates.clear();
+    dfaIndex.clear();
+    dfaMatch.clear();
+    dfaSticky.clear();
+    transitions.clear();
+
+    std::vector<int> start{nfaStart};
+    Closure(start);
+    InternDfaState(std::move(start));          // state 0: start
+    deadState = InternDfaState({});             // no live NFA states left
+
+    for (size_t state = 0; state < dfaStates.size() && dfaStates.size() < EAGER_STATE_BUDGET; ++state) {
+        for (int cls = 0; cls < classCount; ++cls) {
+            ComputeTransition(static_cast<int>(state), cls);
+        }
+    }
+
+    eagerStateCount = dfaStates.size();
+    built = true;
+}
+
+bool PatternAutomaton::Matches(std::string_view input) const {
+    return Find(input) >= 0;
+}
+
+int PatternAutomaton::Find(std::string_view input) const {
+    if (!built || patternCount == 0) {
+        return -1;
+    }
+
+    int state = 0;
+    int found = dfaSticky[0];
+    for (unsigned char c : input) {
+        int cls = byteClass[c];
+        int next = transitions[state * classCount + cls];
+        if (next < 0) {
+            next = ComputeTransition(state, cls);
+        }
+        state = next;
+        if (state == deadState) {
+            return found;
+        }
+        int sticky = dfaSticky[state];
+        if (sticky >= 0 && (found < 0 || sticky < found)) {
+            found = sticky;
+        }
+    }
+    int match = dfaMatch[state];
+    return (match >= 0 && (found < 0 || match < found)) ? match : found;
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Many glob/regex patterns compiled into one DFA, so a match costs one table
+// lookup per input byte no matter how many patterns were added.
+// Matching is ASCII case-insensitive and always against the whole input.
+//
+// Not thread-safe, not even through const: pattern sets whose DFA outgrows
+// the eager budget build further states while matching. An automaton must
+// be owned by one thread at a time (or guarded by its owner's lock).
+class PatternAutomaton {
+public:
+    PatternAutomaton();
+
+    // Glob: * any run, ? any byte, [abc] / [!a-z] classes
+    bool AddGlob(const std::string& pattern, std::string& error);
+    // Regex subset: literals, . [] () | * + ? and \d \w \s escapes.
+    // Unanchored unless the pattern starts with ^ / ends with $.
+    bool AddRegex(const std::string& pattern, std::string& error);
+    // Literal prefix
+    void AddPrefix(const std::string& prefix);
+    // Literal anywhere in the input (multi-string search, Aho-Corasick style)
+    void AddSubstring(const std::string& text);
+
+    // Builds the DFA. Must be called after the last Add*() and before Matches().
+    void Build();
+
+    bool Matches(std::string_view input) const;
+    // Index (in Add*() order) of the first pattern matching input, -1 if none
+    int Find(std::string_view input) const;
+    size_t GetPatternCount() const { return patternCount; }
+    size_t GetStateCount() const { return dfaStates.size(); }
+
+private:
+    using CharSet = std::vector<bool>; // 256 entries
+
+    struct NfaState {
+        int charSet = -1;           // index into charSets, -1 for epsilon-only states
+        int next = -1;              // target when charSet matches
+        std::vector<int> epsilon;   // epsilon transitions
+        int pattern = -1;           // pattern index when accepting
+    };
+
+    struct Fragment {
+        int start;
+        int end; // state with no outgoing transitions yet
+    };
+
+    class RegexParser;
+
+    int NewState();
+    int AddCharSet(const CharSet& set);
+    Fragment Literal(const CharSet& set);
+    Fragment Empty();
+    Fragment Concat(Fragment a, Fragment b);
+    Fragment Alternate(Fragment a, Fragment b);
+    Fragment Star(Fragment a);
+    Fragment Plus(Fragment a);
+    Fragment Optional(Fragment a);
+    void AddPattern(Fragment fragment, bool sticky = false);
+
+    void Closure(std::vector<int>& states) const;
+    int InternDfaState(std::vector<int> states) const;
+    int ComputeTransition(int dfaState, int byteClass) const;
+    void FlushLazyStates() const;
+
+    // NFA
+    std::vector<NfaState> nfa;
+    std::vector<CharSet> charSets;
+    int nfaStart;
+    size_t patternCount = 0;
+    // Substring patterns end at their last byte instead of looping on ".*":
+    // a match anywhere is final, and the DFA stays Aho-Corasick sized rather
+    // than multiplying "already matched" states by everything still pending
+    std::vector<bool> stickyPatterns;
+
+    // DFA over byte equivalence classes; transitions computed eagerly up to a
+    // state budget and lazily (then cached) beyond it. The cache is bounded:
+    // inputs other users control must not be able to grow it without limit.
+    uint8_t byteClass[256];
+    std::vector<uint8_t> classRepresentative;
+    int classCount = 1;
+    int deadState = -1;
+    mutable std::vector<std::vector<int>> dfaStates;
+    mutable std::map<std::vector<int>, int> dfaIndex;
+    mutable std::vector<int> dfaMatch;  // lowest accepted pattern, -1 if none
+    mutable std::vector<int> dfaSticky; // lowest sticky pattern accepted, -1 if none
+    mutable std::vector<int> transitions;
+    size_t eagerStateCount = 0;     // States kept when the lazy ones are flushed
+    bool built = false;
+};
\ No newline at end of file
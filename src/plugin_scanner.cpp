@@ -0,0 +1,196 @@
+#include "plugin_scanner.h"
+#include "logger.h"
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+    struct KnownPlugin {
+        const char* module;        // Lowercase file name without extension or bitness suffix
+        const char* displayName;
+    };
+
+    const KnownPlugin KNOWN_PLUGINS[] = {
+        // Third-party instruments
+        {"serum", "Serum"},
+        {"vital", "Vital"},
+        {"massive", "Massive"},
+        {"massive x", "Massive X"},
+        {"kontakt", "Kontakt"},
+        {"omnisphere", "Omnisphere"},
+        {"nexus", "Nexus"},
+        {"sylenth1", "Sylenth1"},
+        {"spire", "Spire"},
+        {"diva", "Diva"},
+        {"hive", "Hive"},
+        {"pigments", "Pigments"},
+        {"phaseplant", "Phase Plant"},
+        // Third-party effects
+        {"serumfx", "SerumFX"},
+        {"fabfilter pro-q 3", "FabFilter Pro-Q 3"},
+        {"fabfilter pro-c 2", "FabFilter Pro-C 2"},
+        {"fabfilter pro-l 2", "FabFilter Pro-L 2"},
+        {"fabfilter pro-r", "FabFilter Pro-R"},
+        {"fabfilter saturn 2", "FabFilter Saturn 2"},
+        {"valhallavintageverb", "ValhallaVintageVerb"},
+        {"valhallasupermassive", "Valhalla Supermassive"},
+        {"ott", "OTT"},
+        {"decapitator", "Decapitator"},
+        // Image-Line plugins that live outside FL Studio's main module
+        {"sytrus", "Sytrus"},
+        {"harmor", "Harmor"},
+        {"harmless", "Harmless"},
+        {"flex", "FLEX"},
+        {"gross beat", "Gross Beat"},
+        {"vocodex", "Vocodex"},
+        {"transistor bass", "Transistor Bass"}
+    };
+    constexpr size_t KNOWN_PLUGIN_COUNT = sizeof(KNOWN_PLUGINS) / sizeof(KNOWN_PLUGINS[0]);
+
+    // Most vendors ship "Name_x64.dll" or "Name x64.dll" next to the 32-bit build
+    const std::string_view BITNESS_SUFFIXES[] = {"_x64", "(x64)", " x64", "x64", "_64"};
+
+    const std::unordered_map<std::string_view, size_t>& PluginIndex() {
+        static const std::unordered_map<std::string_view, size_t> index = [] {
+            std::unordered_map<std::string_view, size_t> built;
+            for (size_t i = 0; i < KNOWN_PLUGIN_COUNT; ++i) {
+                built.emplace(KNOWN_PLUGINS[i].module, i);
+            }
+            return built;
+        }();
+        return index;
+    }
+
+    bool EndsWithNoCase(std::string_view text, std::string_view suffix) {
+        if (text.size() < suffix.size()) return false;
+        for (size_t i = 0; i < suffix.size(); ++i) {
+            char c = text[text.size() - suffix.size() + i];
+            if (std::tolower(static_cast<unsigned char>(c)) != suffix[i]) return false;
+        }
+        return true;
+    }
+}
+
+PluginScanner::PluginScanner()
+    : buffer(CHUNK_BYTES)
+    , loaded(KNOWN_PLUGIN_COUNT, false)
+    , previous(KNOWN_PLUGIN_COUNT, false) {
+}
+
+bool PluginScanner::Scan(int pid) {
+    if (pid != lastPid) {
+        Reset();
+        lastPid = pid;
+    }
+    char path[64];
+    std::snprintf(path, sizeof(path), "/proc/%d/maps", pid);
+    return ScanFile(path);
+}
+
+void PluginScanner::Reset() {
+    previous.assign(KNOWN_PLUGIN_COUNT, false);
+    plugins.clear();
+    lastPid = 0;
+}
+
+bool PluginScanner::ScanFile(const char* path) {
+    loaded.assign(KNOWN_PLUGIN_COUNT, false);
+
+#ifdef __linux__
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        // Lines are parsed in place; a line cut by the chunk boundary is
+        // moved to the front and completed by the next read
+        size_t filled = 0;
+        while (true) {
+            ssize_t count = read(fd, buffer.data() + filled, buffer.size() - filled);
+            if (count <= 0) break;
+            filled += static_cast<size_t>(count);
+
+            const char* cursor = buffer.data();
+            const char* end = buffer.data() + filled;
+            while (const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor))) {
+                ParseLine(cursor, newline - cursor);
+                cursor = newline + 1;
+            }
+
+            filled = end - cursor;
+            if (filled == buffer.size()) {
+                filled = 0;  // No line is this long; drop it
+            } else if (filled > 0) {
+                std::memmove(buffer.data(), cursor, filled);
+            }
+        }
+        if (filled > 0) {
+            ParseLine(buffer.data(), filled);
+        }
+        close(fd);
+    }
+#else
+    (void)path;
+#endif
+
+    if (loaded == previous) return false;
+
+    // Rebuild the list, logging only what changed since the last scan
+    plugins.clear();
+    for (size_t i = 0; i < KNOWN_PLUGIN_COUNT; ++i) {
+        if (loaded[i]) plugins.push_back(KNOWN_PLUGINS[i].displayName);
+        if (loaded[i] != previous[i]) {
+            LOG_DEBUG("Plugin {} {}", KNOWN_PLUGINS[i].displayName, loaded[i] ? "loaded" : "unloaded");
+        }
+    }
+    previous.swap(loaded);
+    return true;
+}
+
+void PluginScanner::ParseLine(const char* line, size_t length) {
+    // "start-end perms offset dev inode   /path"; only file mappings carry a
+    // '/', and the fields before the path never do
+    const char* slash = static_cast<const char*>(std::memchr(line, '/', length));
+    if (!slash) return;
+    std::string_view path(slash, line + length - slash);
+
+    std::string_view extensions[] = {".dll", ".vst3", ".so"};
+    size_t extensionLength = 0;
+    for (std::string_view extension : extensions) {
+        if (EndsWithNoCase(path, extension)) {
+            extensionLength = extension.size();
+            break;
+        }
+    }
+    if (extensionLength == 0) return;
+
+    size_t nameStart = path.rfind('/') + 1;
+    size_t nameLength = path.size() - nameStart - extensionLength;
+
+    char name[128];
+    if (nameLength == 0 || nameLength >= sizeof(name)) return;
+    for (size_t i = 0; i < nameLength; ++i) {
+        name[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(path[nameStart + i])));
+    }
+
+    std::string_view module(name, nameLength);
+    for (std::string_view suffix : BITNESS_SUFFIXES) {
+        if (module.size() > suffix.size() && module.substr(module.size() - suffix.size()) == suffix) {
+            module.remove_suffix(suffix.size());
+            break;
+        }
+    }
+    while (!module.empty() && module.back() == ' ') {
+        module.remove_suffix(1);
+    }
+
+    const auto& index = PluginIndex();
+    auto found = index.find(module);
+    if (found != index.end()) {
+        loaded[found->second] = true;
+    }
+}
\ No newline at end of file
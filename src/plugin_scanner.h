@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Finds the instruments and effects a running FL Studio has loaded. Plugin
+// modules (.dll, .vst3, .so) are mapped into the process, so under Wine they
+// appear in /proc/<pid>/maps. The file is streamed through a fixed buffer in
+// large chunks and each mapped path is matched against a table of known
+// plugins without allocating per line. Linux only; elsewhere Scan() finds
+// nothing.
+class PluginScanner {
+public:
+    PluginScanner();
+
+    // Re-reads the process's mappings. Returns true when the set of loaded
+    // plugins differs from the previous scan (or the PID changed).
+    bool Scan(int pid);
+    // Same, from any file in maps format
+    bool ScanFile(const char* path);
+    void Reset();
+
+    // Display names in table order, e.g. {"Serum", "FabFilter Pro-Q 3"}
+    const std::vector<std::string>& GetPlugins() const { return plugins; }
+
+private:
+    static constexpr size_t CHUNK_BYTES = 64 * 1024;
+
+    void ParseLine(const char* line, size_t length);
+
+    std::vector<char> buffer;
+    std::vector<bool> loaded;       // Per table entry, filled by the current scan
+    std::vector<bool> previous;     // Result of the last scan
+    std::vector<std::string> plugins;
+    int lastPid = 0;
+};
\ No newline at end of file
@@ -0,0 +1,179 @@
+#include "presence_bus.h"
+#include "json_writer.h"
+#include "logger.h"
+#include <algorithm>
+
+#ifndef _WIN32
+    #include <csignal>
+    #include <pthread.h>
+#endif
+
+PresenceBus::~PresenceBus() {
+    UnsubscribeAll();
+}
+
+PresenceBus::SinkId PresenceBus::Subscribe(std::unique_ptr<PresenceSink> sink, SinkOptions options) {
+    auto subscription = std::make_unique<Subscription>();
+    subscription->sink = std::move(sink);
+    subscription->options = options;
+    if (subscription->options.capacity == 0) {
+        subscription->options.capacity = 1;
+    }
+    if (!options.inlineDelivery) {
+        Subscription* queued = subscription.get();
+        subscription->thread = std::thread([queued] {
+#ifndef _WIN32
+            // Signals belong to the event loop's signalfd, never to this thread
+            sigset_t all;
+            sigfillset(&all);
+            pthread_sigmask(SIG_BLOCK, &all, nullptr);
+#endif
+            RunQueue(*queued);
+        });
+    }
+
+    std::lock_guard<std::mutex> lock(subscriptionsMutex);
+    subscription->id = nextId++;
+    LOG_INFO("Presence sink '{}' subscribed", subscription->sink->GetName());
+    subscriptions.push_back(std::move(subscription));
+    return subscriptions.back()->id;
+}
+
+void PresenceBus::Unsubscribe(SinkId id) {
+    std::unique_ptr<Subscription> removed;
+    {
+        std::lock_guard<std::mutex> lock(subscriptionsMutex);
+        auto it = std::find_if(subscriptions.begin(), subscriptions.end(),
+                               [id](const std::unique_ptr<Subscription>& subscription) { return subscription->id == id; });
+        if (it == subscriptions.end()) return;
+        removed = std::move(*it);
+        subscriptions.erase(it);
+    }
+    Stop(*removed);
+}
+
+void PresenceBus::UnsubscribeAll() {
+    std::vector<std::unique_ptr<Subscription>> removed;
+    {
+        std::lock_guard<std::mutex> lock(subscriptionsMutex);
+        removed.swap(subscriptions);
+    }
+    for (auto& subscription : removed) {
+        Stop(*subscription);
+    }
+}
+
+void PresenceBus::Stop(Subscription& subscription) {
+    {
+        std::lock_guard<std::mutex> lock(subscription.mutex);
+        subscription.stopping = true;
+    }
+    subscription.wake.notify_one();
+    if (subscription.thread.joinable()) {
+        subscription.thread.join();
+    }
+}
+
+void PresenceBus::Publish(const RenderedPresence& presence) {
+    auto event = std::make_shared<PresenceEvent>();
+    event->presence = presence;
+    event->time = std::time(nullptr);
+    WriteJson(*event);
+    std::shared_ptr<const PresenceEvent> shared = std::move(event);
+
+    std::lock_guard<std::mutex> lock(subscriptionsMutex);
+    for (auto& subscription : subscriptions) {
+        if (subscription->options.inlineDelivery) {
+            try {
+                subscription->sink->Deliver(*shared);
+            } catch (const std::exception& e) {
+                LOG_ERROR("Presence sink '{}' failed: {}", subscription->sink->GetName(), e.what());
+            }
+            std::lock_guard<std::mutex> stats(subscription->mutex);
+            ++subscription->delivered;
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> queueLock(subscription->mutex);
+            auto& queue = subscription->queue;
+            if (queue.size() >= subscription->options.capacity) {
+                ++subscription->dropped;
+                if (subscription->options.policy == DropPolicy::DropNewest) continue;
+                queue.pop_front();
+            }
+            queue.push_back(shared);
+        }
+        subscription->wake.notify_one();
+    }
+}
+
+void PresenceBus::RunQueue(Subscription& subscription) {
+    std::unique_lock<std::mutex> lock(subscription.mutex);
+    while (true) {
+        subscription.wake.wait(lock, [&] { return subscription.stopping || !subscription.queue.empty(); });
+        if (subscription.queue.empty()) return;  // Stopping, and drained
+
+        auto event = std::move(subscription.queue.front());
+        subscription.queue.pop_front();
+        uint64_t newDrops = subscription.dropped - subscription.reportedDrops;
+        subscription.reportedDrops = subscription.dropped;
+        lock.unlock();
+
+        // The sink falls behind without ever blocking the publisher
+        if (newDrops > 0) {
+            LOG_WARNING("Presence sink '{}' fell behind, dropped {} update(s)", subscription.sink->GetName(), newDrops);
+        }
+        try {
+            subscription.sink->Deliver(*event);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Presence sink '{}' failed: {}", subscription.sink->GetName(), e.what());
+        }
+
+        lock.lock();
+        ++subscription.delivered;
+    }
+}
+
+std::vector<PresenceBus::SinkStats> PresenceBus::GetStats() const {
+    std::vector<SinkStats> stats;
+    std::lock_guard<std::mutex> lock(subscriptionsMutex);
+    for (const auto& subscription : subscriptions) {
+        std::lock_guard<std::mutex> queueLock(subscription->mutex);
+        SinkStats entry;
+        entry.name = subscription->sink->GetName();
+        entry.delivered = subscription->delivered;
+        entry.dropped = subscription->dropped;
+        entry.queued = subscription->queue.size();
+        stats.push_back(std::move(entry));
+    }
+    return stats;
+}
+
+void PresenceBus::WriteJson(PresenceEvent& event) {
+    const RenderedPresence& presence = event.presence;
+    JsonWriter writer(512);
+    writer.BeginObject();
+    writer.Key("time");
+    writer.Int(static_cast<int64_t>(event.time));
+    writer.Key("active");
+    writer.Bool(presence.active);
+    if (presence.active) {
+        writer.Key("details");
+        writer.String(presence.details.View());
+        writer.Key("state");
+        writer.String(presence.state.View());
+        writer.Key("largeText");
+        writer.String(presence.largeText.View());
+        writer.Key("smallImage");
+        writer.String(presence.smallImage);
+        writer.Key("smallText");
+        writer.String(presence.smallText);
+        if (presence.startTimestamp > 0) {
+            writer.Key("start");
+            writer.Int(static_cast<int64_t>(presence.startTimestamp));
+        }
+    }
+    writer.EndObject();
+    event.json.assign(writer.View());
+}
\ No newline at end of file
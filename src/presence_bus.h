@@ -0,0 +1,99 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "presence_renderer.h"
+
+// One presence change as every sink sees it: rendered once, serialized to
+// JSON once, then shared read-only by all deliveries
+struct PresenceEvent {
+    RenderedPresence presence;   // presence.active == false means cleared
+    std::time_t time = 0;
+    // {"time":..,"active":..,"details":..,"state":..,"largeText":..,
+    //  "smallImage":..,"smallText":..,"start":..}
+    std::string json;
+};
+
+// A consumer of presence changes (Discord, an overlay file, a log, ...)
+class PresenceSink {
+public:
+    virtual ~PresenceSink() = default;
+    virtual const char* GetName() const = 0;
+    virtual void Deliver(const PresenceEvent& event) = 0;
+};
+
+// Fans presence changes out to any number of sinks. Queued sinks each get a
+// bounded queue and a delivery thread of their own, so a sink that stalls
+// only ever fills its own queue; Publish() never waits for one. Inline sinks
+// are delivered to on the publishing thread and must not block (Discord,
+// whose writes go through the event loop).
+class PresenceBus {
+public:
+    enum class DropPolicy {
+        DropOldest,   // A full queue discards its oldest event
+        DropNewest    // A full queue refuses the new event
+    };
+
+    struct SinkOptions {
+        size_t capacity = 16;   // 1 with DropOldest keeps only the latest
+        DropPolicy policy = DropPolicy::DropOldest;
+        bool inlineDelivery = false;
+    };
+
+    struct SinkStats {
+        std::string name;
+        uint64_t delivered = 0;
+        uint64_t dropped = 0;
+        size_t queued = 0;
+    };
+
+    using SinkId = int;
+
+    PresenceBus() = default;
+    ~PresenceBus();
+
+    PresenceBus(const PresenceBus&) = delete;
+    PresenceBus& operator=(const PresenceBus&) = delete;
+
+    SinkId Subscribe(std::unique_ptr<PresenceSink> sink, SinkOptions options);
+    // Delivers what is still queued for the sink, then destroys it. Queued
+    // sinks may be slow but must return from Deliver() eventually.
+    void Unsubscribe(SinkId id);
+    void UnsubscribeAll();
+
+    // Builds the event once and hands it to every sink
+    void Publish(const RenderedPresence& presence);
+
+    std::vector<SinkStats> GetStats() const;
+
+private:
+    struct Subscription {
+        SinkId id = 0;
+        std::unique_ptr<PresenceSink> sink;
+        SinkOptions options;
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::deque<std::shared_ptr<const PresenceEvent>> queue;
+        bool stopping = false;
+        uint64_t delivered = 0;
+        uint64_t dropped = 0;
+        uint64_t reportedDrops = 0;
+        std::thread thread;
+    };
+
+    static void RunQueue(Subscription& subscription);
+    static void Stop(Subscription& subscription);
+    static void WriteJson(PresenceEvent& event);
+
+    mutable std::mutex subscriptionsMutex;
+    std::vector<std::unique_ptr<Subscription>> subscriptions;
+    SinkId nextId = 1;
+};
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "presence_renderer.h"
+#include "config.h"
+#include <cstdio>
+
+namespace {
+    // Shared by every running state: show the project when we are allowed to
+    constexpr const char* DEFAULT_DETAILS = "[Working on {project}]";
+    constexpr const char* DEFAULT_STATE_LINE = "{version}[ • {bpm} BPM][ • {unsaved}]";
+
+    const char* StateLabel(FLStudioState state) {
+        switch (state) {
+            case FLStudioState::NotRunning: return "";
+            case FLStudioState::Idle: return "Idle";
+            case FLStudioState::Composing: return "Composing";
+            case FLStudioState::Playing: return "Playing";
+            case FLStudioState::Recording: return "Recording";
+            case FLStudioState::Paused: return "Paused";
+        }
+        return "";
+    }
+
+    PresenceTemplate CompileBuiltin(const char* source) {
+        PresenceTemplate compiled;
+        std::string error;
+        PresenceTemplate::Compile(source, compiled, error);
+        return compiled;
+    }
+}
+
+FLStudioState GetFLStudioState(const FLStudioInfo& info) {
+    if (!info.isRunning) {
+        return FLStudioState::NotRunning;
+    }
+    if (info.isRecording) {
+        return FLStudioState::Recording;
+    }
+    if (info.isPlaying) {
+        return FLStudioState::Playing;
+    }
+    if (info.isPaused) {
+        return FLStudioState::Paused;
+    }
+    if (!info.projectName.empty()) {
+        return FLStudioState::Composing;
+    }
+    return FLStudioState::Idle;
+}
+
+PresenceRenderer::PresenceRenderer() {
+    SetDefaults();
+}
+
+void PresenceRenderer::SetDefaults() {
+    PresenceTemplate details = CompileBuiltin(DEFAULT_DETAILS);
+
+    states[StateIndex(FLStudioState::NotRunning)] = {PresenceTemplate(), "FL Studio"};
+    states[StateIndex(FLStudioState::Idle)] = {details, "Composing music"};
+    states[StateIndex(FLStudioState::Composing)] = {details, "Composing music"};
+    states[StateIndex(FLStudioState::Playing)] = {details, "Playing music"};
+    states[StateIndex(FLStudioState::Recording)] = {details, "Recording"};
+    states[StateIndex(FLStudioState::Paused)] = {details, "Paused"};
+
+    stateLine = CompileBuiltin(DEFAULT_STATE_LINE);
+}
+
+void PresenceRenderer::Configure(const AppConfig& config, std::string& errors) {
+    SetDefaults();
+
+    showProjectName = config.showProjectName;
+    showBPM = config.showBPM;
+    showPlaybackState = config.showPlaybackState;
+    showUnsavedChanges = config.showUnsavedChanges;
+
+    struct CustomMessage {
+        const char* key;
+        const std::string& source;
+        FLStudioState state;
+    };
+    const CustomMessage messages[] = {
+        {"customIdleMessage", config.customIdleMessage, FLStudioState::Idle},
+        {"customComposingMessage", config.customComposingMessage, FLStudioState::Composing},
+        {"customPlayingMessage", config.customPlayingMessage, FLStudioState::Playing},
+        {"customRecordingMessage", config.customRecordingMessage, FLStudioState::Recording}
+    };
+
+    buttonCount = 0;
+    if (config.enableCustomButtons) {
+        const std::string* buttons[][2] = {
+            {&config.customButton1Label, &config.customButton1Url},
+            {&config.customButton2Label, &config.customButton2Url}
+        };
+        for (const auto& button : buttons) {
+            if (button[0]->empty() || button[1]->empty()) continue;
+            if (button[0]->size() > DISCORD_BUTTON_LABEL_MAX_BYTES || button[1]->size() > DISCORD_BUTTON_URL_MAX_BYTES) {
+                errors += "button '" + *button[0] + "': label or URL exceeds Discord's limit\n";
+                continue;
+            }
+            buttonLabels[buttonCount] = *button[0];
+            buttonUrls[buttonCount] = *button[1];
+            ++buttonCount;
+        }
+    }
+
+    for (const auto& message : messages) {
+        if (message.source.empty()) continue;
+
+        PresenceTemplate compiled;
+        std::string error;
+        if (PresenceTemplate::Compile(message.source, compiled, error)) {
+            states[StateIndex(message.state)].details = std::move(compiled);
+        } else {
+            errors += std::string(message.key) + ": " + error + "\n";
+        }
+    }
+}
+
+void PresenceRenderer::Render(const FLStudioInfo& info, RenderedPresence& out) const {
+    FLStudioState state = GetFLStudioState(info);
+    if (!showPlaybackState && (state == FLStudioState::Playing || state == FLStudioState::Recording)) {
+        state = info.projectName.empty() ? FLStudioState::Idle : FLStudioState::Composing;
+    }
+
+    char bpmText[16] = "";
+    if (showBPM && info.bpm > 0) {
+        std::snprintf(bpmText, sizeof(bpmText), "%d", info.bpm);
+    }
+    char patternText[16] = "";
+    if (info.currentPattern > 0) {
+        std::snprintf(patternText, sizeof(patternText), "%d", info.currentPattern);
+    }
+
+    // "Serum, FabFilter Pro-Q 3"; the field is cut to Discord's limit anyway
+    PresenceField pluginsText;
+    for (const auto& plugin : info.plugins) {
+        if (!pluginsText.Empty()) pluginsText.Append(", ");
+        pluginsText.Append(plugin);
+    }
+
+    TemplateValues values;
+    values.Set(TemplateVariable::Project, showProjectName ? std::string_view(info.projectName) : std::string_view());
+    values.Set(TemplateVariable::Version, info.version);
+    values.Set(TemplateVariable::Bpm, bpmText);
+    values.Set(TemplateVariable::Pattern, patternText);
+    values.Set(TemplateVariable::State, StateLabel(state));
+    values.Set(TemplateVariable::Unsaved, showUnsavedChanges && info.hasUnsavedChanges ? "Unsaved" : "");
+    values.Set(TemplateVariable::Plugins, pluginsText.View());
+
+    const StateTemplate& current = states[StateIndex(state)];
+    current.details.Render(values, out.details);
+    if (out.details.Empty()) {
+        out.details.Assign(current.fallback);
+    }
+
+    stateLine.Render(values, out.state);
+    out.largeText.Assign(info.version);
+
+    out.active = true;
+    out.largeImage = DiscordAssets::FL_STUDIO_LOGO;
+    out.startTimestamp = info.sessionStartTime;
+
+    out.buttonCount = buttonCount;
+    for (size_t i = 0; i < buttonCount; ++i) {
+        out.buttons[i].label.Assign(buttonLabels[i]);
+        out.buttons[i].url.Assign(buttonUrls[i]);
+    }
+
+    switch (state) {
+        case FLStudioState::Recording:
+            out.smallImage = DiscordAssets::RECORDING;
+            out.smallText = "Recording";
+            break;
+        case FLStudioState::Playing:
+            out.smallImage = DiscordAssets::PLAYING;
+            out.smallText = "Playing";
+            break;
+        case FLStudioState::Paused:
+            out.smallImage = DiscordAssets::PAUSED;
+            out.smallText = "Paused";
+            break;
+        case FLStudioState::Composing:
+            out.smallImage = DiscordAssets::COMPOSING;
+            out.smallText = "Composing";
+            break;
+        default:
+            out.smallImage = DiscordAssets::IDLE;
+            out.smallText = "Idle";
+            break;
+    }
+}
\ No newline at end of file
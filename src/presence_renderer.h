@@ -0,0 +1,73 @@
+#pragma once
+
+#include <ctime>
+#include <string>
+#include "presence_template.h"
+#include "../include/fl_studio_types.h"
+
+struct AppConfig;
+
+// Discord limits for activity buttons
+constexpr size_t DISCORD_BUTTON_LABEL_MAX_BYTES = 32;
+constexpr size_t DISCORD_BUTTON_URL_MAX_BYTES = 512;
+constexpr size_t DISCORD_MAX_BUTTONS = 2;
+
+struct PresenceButton {
+    BasicPresenceField<DISCORD_BUTTON_LABEL_MAX_BYTES> label;
+    BasicPresenceField<DISCORD_BUTTON_URL_MAX_BYTES> url;
+};
+
+// Everything a presence transport needs, rendered once per state change
+struct RenderedPresence {
+    bool active = false;   // false clears the activity
+    PresenceField details;
+    PresenceField state;
+    PresenceField largeText;
+    const char* largeImage = DiscordAssets::FL_STUDIO_LOGO;
+    const char* smallImage = DiscordAssets::IDLE;
+    const char* smallText = "Idle";
+    std::time_t startTimestamp = 0;
+    PresenceButton buttons[DISCORD_MAX_BUTTONS];
+    size_t buttonCount = 0;
+};
+
+// Turns FLStudioInfo into presence text using compiled templates and the
+// user's privacy settings. Templates are compiled in Configure(); Render()
+// writes into the caller's RenderedPresence without allocating.
+class PresenceRenderer {
+public:
+    PresenceRenderer();
+
+    // Compiles custom messages from the config. Invalid templates fall back to
+    // the built-in default and are reported through errors (one line each).
+    void Configure(const AppConfig& config, std::string& errors);
+
+    void SetShowProjectName(bool show) { showProjectName = show; }
+    void SetShowBPM(bool show) { showBPM = show; }
+
+    void Render(const FLStudioInfo& info, RenderedPresence& out) const;
+
+private:
+    static constexpr size_t STATE_COUNT = 6;
+
+    struct StateTemplate {
+        PresenceTemplate details;
+        const char* fallback = "";  // used when the details template renders empty
+    };
+
+    static size_t StateIndex(FLStudioState state) { return static_cast<size_t>(state); }
+    void SetDefaults();
+
+    StateTemplate states[STATE_COUNT];
+    PresenceTemplate stateLine;
+    std::string buttonLabels[DISCORD_MAX_BUTTONS];
+    std::string buttonUrls[DISCORD_MAX_BUTTONS];
+    size_t buttonCount = 0;
+
+    bool showProjectName = true;
+    bool showBPM = true;
+    bool showPlaybackState = true;
+    bool showUnsavedChanges = true;
+};
+
+FLStudioState GetFLStudioState(const FLStudioInfo& info);
\ No newline at end of file
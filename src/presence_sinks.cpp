@@ -0,0 +1,68 @@
+#include "presence_sinks.h"
+#include "logger.h"
+#include <utility>
+
+#ifdef _WIN32
+    #include <windows.h>
+#endif
+
+namespace {
+    bool MoveIntoPlace(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+        // rename() refuses to overwrite an existing file on Windows
+        return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+    }
+}
+
+OverlayFileSink::OverlayFileSink(std::string path)
+    : path(std::move(path)) {
+}
+
+void OverlayFileSink::Deliver(const PresenceEvent& event) {
+    std::string temporary = path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (!file) {
+        LOG_WARNING("Cannot write overlay file {}", temporary);
+        return;
+    }
+
+    if (event.presence.active) {
+        std::fprintf(file, "%s\n%s\n", event.presence.details.CStr(), event.presence.state.CStr());
+    }
+    bool written = std::fclose(file) == 0;
+    if (!written || !MoveIntoPlace(temporary, path)) {
+        LOG_WARNING("Cannot replace overlay file {}", path);
+        std::remove(temporary.c_str());
+    }
+}
+
+ActivityLogSink::ActivityLogSink(std::string path)
+    : path(std::move(path)) {
+}
+
+ActivityLogSink::~ActivityLogSink() {
+    if (file) std::fclose(file);
+}
+
+void ActivityLogSink::Deliver(const PresenceEvent& event) {
+    // Opened lazily, and again after a failed write (e.g. the file was rotated away)
+    if (!file) {
+        file = std::fopen(path.c_str(), "ab");
+        if (!file) {
+            LOG_WARNING("Cannot open activity log {}", path);
+            return;
+        }
+    }
+
+    bool written = std::fwrite(event.json.data(), 1, event.json.size(), file) == event.json.size() &&
+                   std::fputc('\n', file) != EOF &&
+                   std::fflush(file) == 0;
+    if (!written) {
+        LOG_WARNING("Cannot append to activity log {}", path);
+        std::fclose(file);
+        file = nullptr;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include "presence_bus.h"
+
+// Text file for an OBS "read from file" text source: the details line and
+// the state line, or nothing while no presence is shown. Replaced by
+// rename() so OBS never reads a half-written file.
+class OverlayFileSink : public PresenceSink {
+public:
+    explicit OverlayFileSink(std::string path);
+
+    const char* GetName() const override { return "overlay file"; }
+    void Deliver(const PresenceEvent& event) override;
+
+private:
+    std::string path;
+};
+
+// Appends every presence change to a JSON Lines file
+class ActivityLogSink : public PresenceSink {
+public:
+    explicit ActivityLogSink(std::string path);
+    ~ActivityLogSink() override;
+
+    const char* GetName() const override { return "activity log"; }
+    void Deliver(const PresenceEvent& event) override;
+
+private:
+    std::string path;
+    std::FILE* file = nullptr;
+};
\ No newline at end of file
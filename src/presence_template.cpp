@@ -0,0 +1,173 @@
+#include "presence_template.h"
+#include <cstring>
+
+namespace {
+    constexpr size_t MAX_GROUP_DEPTH = 16;
+
+    struct VariableName {
+        const char* name;
+        TemplateVariable variable;
+    };
+
+    const VariableName VARIABLE_NAMES[] = {
+        {"project", TemplateVariable::Project},
+        {"version", TemplateVariable::Version},
+        {"bpm", TemplateVariable::Bpm},
+        {"pattern", TemplateVariable::Pattern},
+        {"state", TemplateVariable::State},
+        {"unsaved", TemplateVariable::Unsaved},
+        {"plugins", TemplateVariable::Plugins}
+    };
+}
+
+bool PresenceTemplate::Compile(const std::string& source, PresenceTemplate& out, std::string& error) {
+    PresenceTemplate compiled;
+    compiled.source = source;
+
+    std::vector<size_t> openGroups;
+    size_t literalBytes = 0;
+
+    auto appendLiteral = [&](const char* text, size_t length) {
+        if (!compiled.segments.empty() &&
+            compiled.segments.back().kind == Segment::Kind::Literal &&
+            compiled.segments.back().offset + compiled.segments.back().length == compiled.literals.size()) {
+            compiled.segments.back().length += length;
+        } else {
+            Segment segment;
+            segment.kind = Segment::Kind::Literal;
+            segment.offset = compiled.literals.size();
+            segment.length = length;
+            compiled.segments.push_back(segment);
+        }
+        compiled.literals.append(text, length);
+        literalBytes += length;
+    };
+
+    for (size_t i = 0; i < source.size(); ++i) {
+        char c = source[i];
+        bool doubled = i + 1 < source.size() && source[i + 1] == c;
+
+        if ((c == '{' || c == '}' || c == '[' || c == ']') && doubled) {
+            appendLiteral(&c, 1);
+            ++i;
+            continue;
+        }
+
+        if (c == '{') {
+            size_t close = source.find('}', i + 1);
+            if (close == std::string::npos) {
+                error = "unterminated '{' at position " + std::to_string(i);
+                return false;
+            }
+
+            std::string name = source.substr(i + 1, close - i - 1);
+            bool found = false;
+            for (const auto& entry : VARIABLE_NAMES) {
+                if (name == entry.name) {
+                    Segment segment;
+                    segment.kind = Segment::Kind::Variable;
+                    segment.variable = entry.variable;
+                    compiled.segments.push_back(segment);
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                error = "unknown variable '{" + name + "}'";
+                return false;
+            }
+            i = close;
+        } else if (c == '}') {
+            error = "unmatched '}' at position " + std::to_string(i);
+            return false;
+        } else if (c == '[') {
+            if (openGroups.size() >= MAX_GROUP_DEPTH) {
+                error = "optional groups nested too deeply";
+                return false;
+            }
+            openGroups.push_back(compiled.segments.size());
+            Segment segment;
+            segment.kind = Segment::Kind::GroupBegin;
+            compiled.segments.push_back(segment);
+        } else if (c == ']') {
+            if (openGroups.empty()) {
+                error = "unmatched ']' at position " + std::to_string(i);
+                return false;
+            }
+            compiled.segments[openGroups.back()].groupEnd = compiled.segments.size();
+            openGroups.pop_back();
+            Segment segment;
+            segment.kind = Segment::Kind::GroupEnd;
+            compiled.segments.push_back(segment);
+        } else {
+            appendLiteral(&c, 1);
+        }
+    }
+
+    if (!openGroups.empty()) {
+        error = "unterminated '['";
+        return false;
+    }
+
+    if (literalBytes > DISCORD_FIELD_MAX_BYTES) {
+        error = "fixed text is " + std::to_string(literalBytes) + " bytes, Discord allows at most " +
+                std::to_string(DISCORD_FIELD_MAX_BYTES);
+        return false;
+    }
+
+    out = std::move(compiled);
+    return true;
+}
+
+void PresenceTemplate::Render(const TemplateValues& values, PresenceField& out) const {
+    out.Clear();
+
+    // Rollback points for open optional groups (groups nest at most a few deep)
+    struct Mark {
+        size_t length;
+        bool truncated;
+    };
+    Mark marks[MAX_GROUP_DEPTH];
+    size_t depth = 0;
+
+    for (size_t i = 0; i < segments.size(); ++i) {
+        const Segment& segment = segments[i];
+
+        switch (segment.kind) {
+            case Segment::Kind::Literal:
+                out.Append(std::string_view(literals.data() + segment.offset, segment.length));
+                break;
+
+            case Segment::Kind::Variable: {
+                std::string_view value = values.Get(segment.variable);
+                if (value.empty() && depth > 0) {
+                    // Drop the innermost group and everything rendered since it opened
+                    --depth;
+                    out.length = marks[depth].length;
+                    out.truncated = marks[depth].truncated;
+                    out.data[out.length] = '\0';
+
+                    size_t groupStart = i;
+                    while (segments[groupStart].kind != Segment::Kind::GroupBegin ||
+                           segments[groupStart].groupEnd < i) {
+                        --groupStart;
+                    }
+                    i = segments[groupStart].groupEnd;
+                    break;
+                }
+                out.Append(value);
+                break;
+            }
+
+            case Segment::Kind::GroupBegin:
+                marks[depth++] = {out.length, out.truncated};
+                break;
+
+            case Segment::Kind::GroupEnd:
+                if (depth > 0) {
+                    --depth;
+                }
+                break;
+        }
+    }
+}
\ No newline at end of file
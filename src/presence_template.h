@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Discord rejects activity text fields (details, state, image text) longer than this
+constexpr size_t DISCORD_FIELD_MAX_BYTES = 128;
+
+// Fixed-capacity text field. Rendering into it never allocates, and
+// overlong input is cut on a UTF-8 code point boundary.
+template <size_t N>
+class BasicPresenceField {
+public:
+    static constexpr size_t Capacity = N;
+
+    BasicPresenceField() { Clear(); }
+
+    void Clear() {
+        data[0] = '\0';
+        length = 0;
+        truncated = false;
+    }
+
+    void Assign(std::string_view text) {
+        Clear();
+        Append(text);
+    }
+
+    void Append(std::string_view text) {
+        size_t available = Capacity - length;
+        size_t count = text.size();
+
+        if (count > available) {
+            count = available;
+            // Never split a multi-byte sequence: back up to the start of the code point
+            while (count > 0 && (static_cast<unsigned char>(text[count]) & 0xC0) == 0x80) {
+                --count;
+            }
+            truncated = true;
+        }
+
+        std::memcpy(data + length, text.data(), count);
+        length += count;
+        data[length] = '\0';
+    }
+
+    const char* CStr() const { return data; }
+    size_t Length() const { return length; }
+    bool Empty() const { return length == 0; }
+    bool IsTruncated() const { return truncated; }
+    std::string_view View() const { return std::string_view(data, length); }
+    std::string ToString() const { return std::string(data, length); }
+
+    bool operator==(const BasicPresenceField& other) const { return View() == other.View(); }
+    bool operator!=(const BasicPresenceField& other) const { return !(*this == other); }
+
+private:
+    friend class PresenceTemplate;
+
+    char data[Capacity + 1];
+    size_t length = 0;
+    bool truncated = false;
+};
+
+using PresenceField = BasicPresenceField<DISCORD_FIELD_MAX_BYTES>;
+
+// Values a template can reference. Empty values make optional groups disappear.
+enum class TemplateVariable {
+    Project,   // {project}
+    Version,   // {version}
+    Bpm,       // {bpm}
+    Pattern,   // {pattern}
+    State,     // {state}
+    Unsaved,   // {unsaved}
+    Plugins,   // {plugins}
+    Count
+};
+
+struct TemplateValues {
+    std::string_view values[static_cast<size_t>(TemplateVariable::Count)];
+
+    void Set(TemplateVariable variable, std::string_view value) {
+        values[static_cast<size_t>(variable)] = value;
+    }
+    std::string_view Get(TemplateVariable variable) const {
+        return values[static_cast<size_t>(variable)];
+    }
+};
+
+// Presence message template, e.g. "{project}[ @ {bpm} BPM]".
+//   {name}   substitutes a variable
+//   [ ... ]  optional group, dropped when any variable inside it is empty
+//   {{ }} [[ ]] produce literal braces/brackets
+// Templates are compiled once into a flat segment list; Render() only copies bytes.
+class PresenceTemplate {
+public:
+    PresenceTemplate() = default;
+
+    static bool Compile(const std::string& source, PresenceTemplate& out, std::string& error);
+
+    void Render(const TemplateValues& values, PresenceField& out) const;
+    bool IsEmpty() const { return segments.empty(); }
+    const std::string& GetSource() const { return source; }
+
+private:
+    struct Segment {
+        enum class Kind { Literal, Variable, GroupBegin, GroupEnd };
+        Kind kind = Kind::Literal;
+        size_t offset = 0;   // Literal: offset into literals
+        size_t length = 0;   // Literal: byte count
+        TemplateVariable variable = TemplateVariable::Project;
+        size_t groupEnd = 0; // GroupBegin: index of the matching GroupEnd
+    };
+
+    std::string source;
+    std::string literals;
+    std::vector<Segment> segments;
+};
\ No newline at end of file
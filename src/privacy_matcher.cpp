@@ -0,0 +1,110 @@
+#include "privacy_matcher.h"
+
+namespace {
+    unsigned char Fold(unsigned char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c - 'A' + 'a') : c;
+    }
+
+    // FNV-1a over the lowercased bytes, so lookups need no temporary string
+    uint64_t FoldedHash(std::string_view value) {
+        uint64_t hash = 1469598103934665603ull;
+        for (unsigned char c : value) {
+            hash ^= Fold(c);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    bool FoldedEquals(std::string_view folded, std::string_view value) {
+        if (folded.size() != value.size()) return false;
+        for (size_t i = 0; i < value.size(); ++i) {
+            if (static_cast<unsigned char>(folded[i]) != Fold(static_cast<unsigned char>(value[i]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool StartsWith(const std::string& value, const char* prefix, std::string& rest) {
+        size_t length = std::char_traits<char>::length(prefix);
+        if (value.compare(0, length, prefix) == 0) {
+            rest = value.substr(length);
+            return true;
+        }
+        return false;
+    }
+}
+
+bool PrivacyMatcher::Field::AddRule(const std::string& rule, std::string& error) {
+    std::string body;
+    if (StartsWith(rule, "re:", body)) {
+        return patterns.AddRegex(body, error);
+    }
+    if (StartsWith(rule, "prefix:", body)) {
+        patterns.AddPrefix(body);
+        return true;
+    }
+    if (rule.find_first_of("*?[") != std::string::npos) {
+        return patterns.AddGlob(rule, error);
+    }
+
+    std::string folded;
+    folded.reserve(rule.size());
+    for (unsigned char c : rule) {
+        folded += static_cast<char>(Fold(c));
+    }
+    exact[FoldedHash(rule)].push_back(std::move(folded));
+    return true;
+}
+
+bool PrivacyMatcher::Field::Matches(std::string_view value) const {
+    if (!exact.empty()) {
+        auto bucket = exact.find(FoldedHash(value));
+        if (bucket != exact.end()) {
+            for (const auto& candidate : bucket->second) {
+                if (FoldedEquals(candidate, value)) return true;
+            }
+        }
+    }
+    return patterns.Matches(value);
+}
+
+bool PrivacyMatcher::Compile(const std::vector<std::string>& rules, std::string& errors) {
+    name = Field();
+    path = Field();
+    ruleCount = 0;
+
+    for (const auto& raw : rules) {
+        // Trim surrounding whitespace; empty entries are ignored
+        size_t first = raw.find_first_not_of(" \t\r\n");
+        if (first == std::string::npos) continue;
+        std::string rule = raw.substr(first, raw.find_last_not_of(" \t\r\n") - first + 1);
+
+        std::string body;
+        Field& field = StartsWith(rule, "path:", body) ? path : name;
+        if (&field == &name) {
+            body = rule;
+        }
+
+        std::string error;
+        if (field.AddRule(body, error)) {
+            ++ruleCount;
+        } else {
+            errors += "hiddenProjects rule '" + rule + "': " + error + "\n";
+        }
+    }
+
+    name.patterns.Build();
+    path.patterns.Build();
+    return errors.empty();
+}
+
+bool PrivacyMatcher::IsHidden(std::string_view projectName, std::string_view projectPath) const {
+    if (ruleCount == 0) {
+        return false;
+    }
+    if (!projectName.empty() && name.Matches(projectName)) {
+        return true;
+    }
+    return !projectPath.empty() && path.Matches(projectPath);
+}
\ No newline at end of file
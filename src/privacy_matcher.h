@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "pattern_automaton.h"
+
+// Compiled form of AppConfig::hiddenProjects. Rule syntax, one rule per entry:
+//   My Song              exact project name
+//   client_* / demo?     glob on the project name (* ? [a-z])
+//   prefix:WIP -         project name prefix
+//   re:^nda_[0-9]+$      regular expression on the project name
+//   path:<rule>          any of the above, applied to the project path instead
+// All rules are case-insensitive. Exact names go into a hash table and every
+// pattern into one automaton per field, so a check costs the same whether
+// there are 3 rules or 3000.
+class PrivacyMatcher {
+public:
+    bool Compile(const std::vector<std::string>& rules, std::string& errors);
+
+    bool IsHidden(std::string_view projectName, std::string_view projectPath) const;
+    size_t GetRuleCount() const { return ruleCount; }
+
+private:
+    struct Field {
+        std::unordered_map<uint64_t, std::vector<std::string>> exact; // folded-hash -> folded names
+        PatternAutomaton patterns;
+
+        bool AddRule(const std::string& rule, std::string& error);
+        bool Matches(std::string_view value) const;
+    };
+
+    Field name;
+    Field path;
+    size_t ruleCount = 0;
+};
\ No newline at end of file
@@ -1,6 +1,6 @@
 #include "process_detector.h"
-#include <iostream>
 #include <algorithm>
+#include <cstring>
 #include <signal.h>
 
 // Platform-specific includes
@@ -14,30 +14,149 @@
     #import <AppKit/AppKit.h>
     #import <Foundation/Foundation.h>
 #else // Linux
+    #include <cerrno>
+    #include <chrono>
     #include <dirent.h>
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <spawn.h>
     #include <unistd.h>
     #include <sys/types.h>
-    #include <fstream>
+    #include <sys/wait.h>
+    #include <cstdio>
     #include <cstdlib>
+    #include <string_view>
 #endif
 
-std::vector<ProcessInfo> CrossPlatformProcessDetector::GetAllProcesses() {
+#if !defined(_WIN32) && !defined(__APPLE__)
+namespace {
+    // Window-title helpers may hang (a wedged X server, say); each is
+    // killed after this long so its caller always gets its thread back
+    constexpr std::chrono::milliseconds HELPER_TIMEOUT{1000};
+    constexpr size_t MAX_HELPER_OUTPUT = 64 * 1024;
+    
+    // Reads up to size bytes of a small /proc file into buffer
+    size_t ReadProcFile(const char* path, char* buffer, size_t size) {
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return 0;
+        ssize_t length = read(fd, buffer, size);
+        close(fd);
+        return length > 0 ? static_cast<size_t>(length) : 0;
+    }
+    
+    // Runs a helper program without a shell and collects its standard
+    // output. Callers may be threads that block every signal; the helper
+    // starts with an empty mask and default dispositions instead, so SIGINT
+    // and SIGTERM stop it like any other process. False if it could not be
+    // started, failed to finish in time, or wrote too much.
+    bool RunHelper(const char* const argv[], std::string& output) {
+        int pipeFds[2];
+        if (pipe2(pipeFds, O_CLOEXEC) != 0) return false;
+        
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+        posix_spawn_file_actions_adddup2(&actions, pipeFds[1], STDOUT_FILENO);
+        posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+        
+        sigset_t unblocked;
+        sigemptyset(&unblocked);
+        sigset_t defaults;
+        sigemptyset(&defaults);
+        for (int signal : {SIGHUP, SIGINT, SIGQUIT, SIGTERM, SIGPIPE}) {
+            sigaddset(&defaults, signal);
+        }
+        posix_spawnattr_t attributes;
+        posix_spawnattr_init(&attributes);
+        posix_spawnattr_setsigmask(&attributes, &unblocked);
+        posix_spawnattr_setsigdefault(&attributes, &defaults);
+        posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+        
+        pid_t child;
+        int spawned = posix_spawnp(&child, argv[0], &actions, &attributes, const_cast<char* const*>(argv), environ);
+        posix_spawn_file_actions_destroy(&actions);
+        posix_spawnattr_destroy(&attributes);
+        close(pipeFds[1]);
+        if (spawned != 0) {
+            close(pipeFds[0]);
+            return false;
+        }
+        
+        auto deadline = std::chrono::steady_clock::now() + HELPER_TIMEOUT;
+        bool complete = false;
+        char buffer[4096];
+        while (output.size() <= MAX_HELPER_OUTPUT) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            if (remaining <= 0) break;
+            pollfd readable{pipeFds[0], POLLIN, 0};
+            int ready = poll(&readable, 1, static_cast<int>(remaining));
+            if (ready < 0 && errno == EINTR) continue;
+            if (ready <= 0) break;
+            ssize_t count = read(pipeFds[0], buffer, sizeof(buffer));
+            if (count < 0 && errno == EINTR) continue;
+            if (count <= 0) {
+                complete = count == 0;
+                break;
+            }
+            output.append(buffer, static_cast<size_t>(count));
+        }
+        close(pipeFds[0]);
+        
+        // A helper that closed its output may still be exiting; one that
+        // overran is not waited for
+        while (true) {
+            pid_t reaped = waitpid(child, nullptr, WNOHANG);
+            if (reaped < 0 && errno == EINTR) continue;
+            if (reaped != 0) break;
+            if (!complete || std::chrono::steady_clock::now() >= deadline) {
+                kill(child, SIGKILL);
+                while (waitpid(child, nullptr, 0) < 0 && errno == EINTR) {}
+                return false;
+            }
+            usleep(5000);
+        }
+        return complete;
+    }
+}
+#endif
+
+void CrossPlatformProcessDetector::ScanProcesses(ProcessTable& table) {
+    table.BeginScan();
 #ifdef _WIN32
-    return GetProcessesWindows();
+    ScanProcessesWindows(table);
 #elif __APPLE__
-    return GetProcessesMacOS();
+    ScanProcessesMacOS(table);
 #else
-    return GetProcessesLinux();
+    ScanProcessesLinux(table);
 #endif
 }
 
+std::vector<ProcessInfo> CrossPlatformProcessDetector::GetAllProcesses(bool includeWindowTitles) {
+    ProcessTable table;
+    ScanProcesses(table);
+    
+    std::vector<ProcessInfo> processes;
+    processes.reserve(table.Size());
+    for (size_t row = 0; row < table.Size(); ++row) {
+        processes.push_back(table.ToProcessInfo(row));
+        if (includeWindowTitles) {
+            processes.back().windowTitle = GetWindowTitle(processes.back().pid);
+        }
+    }
+    return processes;
+}
+
 std::vector<ProcessInfo> CrossPlatformProcessDetector::GetProcessesByName(const std::string& processName) {
-    auto allProcesses = GetAllProcesses();
+    ProcessTable table;
+    ScanProcesses(table);
     std::vector<ProcessInfo> filtered;
     
-    for (const auto& process : allProcesses) {
-        if (process.name.find(processName) != std::string::npos) {
-            filtered.push_back(process);
+    // Only matching rows are materialized
+    for (size_t row = 0; row < table.Size(); ++row) {
+        if (table.GetName(row).find(processName) != std::string_view::npos) {
+            filtered.push_back(table.ToProcessInfo(row));
+            filtered.back().windowTitle = GetWindowTitle(filtered.back().pid);
         }
     }
     
@@ -54,6 +173,58 @@ std::string CrossPlatformProcessDetector::GetWindowTitle(int pid) {
 #endif
 }
 
+int CrossPlatformProcessDetector::GetProcessOwner(int pid) {
+#if defined(_WIN32) || defined(__APPLE__)
+    (void)pid;
+    return -1;
+#else
+    // "Uid:\t<real>\t<effective>\t<saved>\t<fs>" in /proc/<pid>/status
+    char path[64];
+    char status[2048];
+    std::snprintf(path, sizeof(path), "/proc/%d/status", pid);
+    size_t length = ReadProcFile(path, status, sizeof(status) - 1);
+    status[length] = '\0';
+    
+    const char* line = std::strstr(status, "\nUid:");
+    if (!line) return -1;
+    return static_cast<int>(std::strtol(line + 5, nullptr, 10));
+#endif
+}
+
+uint64_t CrossPlatformProcessDetector::GetProcessStartTime(int pid) {
+    if (pid <= 0) return 0;
+    
+#ifdef _WIN32
+    HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+    if (process == nullptr) return 0;
+    FILETIME creation, exit, kernel, user;
+    bool ok = GetProcessTimes(process, &creation, &exit, &kernel, &user) != 0;
+    CloseHandle(process);
+    if (!ok) return 0;
+    return (static_cast<uint64_t>(creation.dwHighDateTime) << 32) | creation.dwLowDateTime;
+#elif __APPLE__
+    struct proc_bsdinfo info;
+    if (proc_pidinfo(pid, PROC_PIDTBSDINFO, 0, &info, sizeof(info)) != sizeof(info)) return 0;
+    return static_cast<uint64_t>(info.pbi_start_tvsec) * 1000000 + info.pbi_start_tvusec;
+#else
+    // Field 22 of /proc/<pid>/stat, in clock ticks since boot. The command
+    // name (field 2) may contain spaces, so count from its closing ')'.
+    char path[64];
+    char stat[1024];
+    std::snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    size_t length = ReadProcFile(path, stat, sizeof(stat) - 1);
+    stat[length] = '\0';
+    
+    // A zombie (state Z, field 3) has already exited
+    const char* field = std::strrchr(stat, ')');
+    if (!field || (field[1] == ' ' && field[2] == 'Z')) return 0;
+    for (int index = 2; index < 22 && field; ++index) {
+        field = std::strchr(field + 1, ' ');
+    }
+    return field ? std::strtoull(field + 1, nullptr, 10) : 0;
+#endif
+}
+
 bool CrossPlatformProcessDetector::IsProcessRunning(const std::string& processName) {
     auto processes = GetProcessesByName(processName);
     return !processes.empty();
@@ -75,38 +246,33 @@ bool CrossPlatformProcessDetector::IsProcessRunning(int pid) {
 }
 
 #ifdef _WIN32
-std::vector<ProcessInfo> CrossPlatformProcessDetector::GetProcessesWindows() {
-    std::vector<ProcessInfo> processes;
-    
+void CrossPlatformProcessDetector::ScanProcessesWindows(ProcessTable& table) {
     HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
-    if (snapshot == INVALID_HANDLE_VALUE) return processes;
+    if (snapshot == INVALID_HANDLE_VALUE) return;
     
     PROCESSENTRY32 entry;
     entry.dwSize = sizeof(PROCESSENTRY32);
     
     if (Process32First(snapshot, &entry)) {
         do {
-            ProcessInfo info;
-            info.pid = entry.th32ProcessID;
-            info.name = entry.szExeFile;
-            info.windowTitle = GetWindowTitleWindows(info.pid);
+            int pid = static_cast<int>(entry.th32ProcessID);
             
             // Get executable path
-            HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, info.pid);
+            char path[MAX_PATH];
+            path[0] = '\0';
+            HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, pid);
             if (hProcess) {
-                char path[MAX_PATH];
-                if (GetModuleFileNameExA(hProcess, nullptr, path, MAX_PATH)) {
-                    info.executablePath = path;
+                if (!GetModuleFileNameExA(hProcess, nullptr, path, MAX_PATH)) {
+                    path[0] = '\0';
                 }
                 CloseHandle(hProcess);
             }
             
-            processes.push_back(info);
+            table.Add(pid, entry.szExeFile, path);
         } while (Process32Next(snapshot, &entry));
     }
     
     CloseHandle(snapshot);
-    return processes;
 }
 
 std::string CrossPlatformProcessDetector::GetWindowTitleWindows(int pid) {
@@ -140,40 +306,33 @@ std::string CrossPlatformProcessDetector::GetWindowTitleWindows(int pid) {
 }
 
 #elif __APPLE__
-std::vector<ProcessInfo> CrossPlatformProcessDetector::GetProcessesMacOS() {
-    std::vector<ProcessInfo> processes;
+void CrossPlatformProcessDetector::ScanProcessesMacOS(ProcessTable& table) {
+    // Reused between scans; only grows when the process count does
+    static thread_local std::vector<pid_t> pids;
     
     int numberOfProcesses = proc_listpids(PROC_ALL_PIDS, 0, nullptr, 0);
-    std::vector<pid_t> pids(numberOfProcesses);
+    if (numberOfProcesses <= 0) return;
+    pids.resize(numberOfProcesses);
     
-    proc_listpids(PROC_ALL_PIDS, 0, pids.data(), numberOfProcesses * sizeof(pid_t));
+    int bytes = proc_listpids(PROC_ALL_PIDS, 0, pids.data(), numberOfProcesses * sizeof(pid_t));
+    pids.resize(std::max(bytes, 0) / sizeof(pid_t));
     
     for (pid_t pid : pids) {
         if (pid == 0) continue;
         
-        ProcessInfo info;
-        info.pid = pid;
-        
-        // Get executable path
+        // Get executable path; the name is its last component
         char pathBuffer[PROC_PIDPATHINFO_MAXSIZE];
-        if (proc_pidpath(pid, pathBuffer, sizeof(pathBuffer)) > 0) {
-            info.executablePath = pathBuffer;
-            
-            // Extract process name from path
-            std::string path(pathBuffer);
+        std::string_view path;
+        std::string_view name;
+        int length = proc_pidpath(pid, pathBuffer, sizeof(pathBuffer));
+        if (length > 0) {
+            path = std::string_view(pathBuffer, length);
             size_t lastSlash = path.find_last_of('/');
-            if (lastSlash != std::string::npos) {
-                info.name = path.substr(lastSlash + 1);
-            } else {
-                info.name = path;
-            }
+            name = lastSlash != std::string_view::npos ? path.substr(lastSlash + 1) : path;
         }
         
-        info.windowTitle = GetWindowTitleMacOS(pid);
-        processes.push_back(info);
+        table.Add(pid, name, path);
     }
-    
-    return processes;
 }
 
 std::string CrossPlatformProcessDetector::GetWindowTitleMacOS(int pid) {
@@ -195,92 +354,83 @@ std::string CrossPlatformProcessDetector::GetWindowTitleMacOS(int pid) {
 }
 
 #else // Linux
-std::vector<ProcessInfo> CrossPlatformProcessDetector::GetProcessesLinux() {
-    std::vector<ProcessInfo> processes;
-    
+void CrossPlatformProcessDetector::ScanProcessesLinux(ProcessTable& table) {
     DIR* procDir = opendir("/proc");
-    if (!procDir) return processes;
+    if (!procDir) return;
+    
+    // Stack buffers only: everything that survives the scan lives in the table
+    char path[64];
+    char commBuffer[64];
+    char cmdlineBuffer[4096];
     
     struct dirent* entry;
     while ((entry = readdir(procDir)) != nullptr) {
         int pid = atoi(entry->d_name);
         if (pid <= 0) continue;
         
-        ProcessInfo info;
-        info.pid = pid;
-        
         // Read process name from /proc/PID/comm
-        std::string commPath = "/proc/" + std::string(entry->d_name) + "/comm";
-        std::ifstream commFile(commPath);
-        if (commFile.is_open()) {
-            std::getline(commFile, info.name);
-            commFile.close();
+        std::snprintf(path, sizeof(path), "/proc/%d/comm", pid);
+        std::string_view name(commBuffer, ReadProcFile(path, commBuffer, sizeof(commBuffer)));
+        size_t newline = name.find('\n');
+        if (newline != std::string_view::npos) {
+            name = name.substr(0, newline);
         }
         
-        // Read command line for full path
-        std::string cmdlinePath = "/proc/" + std::string(entry->d_name) + "/cmdline";
-        std::ifstream cmdlineFile(cmdlinePath);
-        if (cmdlineFile.is_open()) {
-            std::string cmdline;
-            std::getline(cmdlineFile, cmdline, '\0');
-            
-            if (!cmdline.empty()) {
-                info.executablePath = cmdline;
-                
-                // Use full name from cmdline if comm was truncated
-                if (info.name.length() >= 15) {
-                    size_t lastSlash = cmdline.find_last_of('/');
-                    if (lastSlash != std::string::npos) {
-                        info.name = cmdline.substr(lastSlash + 1);
-                    }
-                }
+        // Read command line for full path (its first argument)
+        std::snprintf(path, sizeof(path), "/proc/%d/cmdline", pid);
+        std::string_view cmdline(cmdlineBuffer, ReadProcFile(path, cmdlineBuffer, sizeof(cmdlineBuffer)));
+        cmdline = cmdline.substr(0, cmdline.find('\0'));
+        
+        // Use full name from cmdline if comm was truncated
+        if (name.length() >= 15) {
+            size_t lastSlash = cmdline.find_last_of('/');
+            if (lastSlash != std::string_view::npos) {
+                name = cmdline.substr(lastSlash + 1);
             }
-            cmdlineFile.close();
         }
         
-        info.windowTitle = GetWindowTitleLinux(pid);
-        processes.push_back(info);
+        table.Add(pid, name, cmdline);
     }
     
     closedir(procDir);
-    return processes;
 }
 
 std::string CrossPlatformProcessDetector::GetWindowTitleLinux(int pid) {
     // Try multiple methods for different window managers
+    std::string pidText = std::to_string(pid);
+    std::string output;
     
-    // Method 1: xdotool
-    std::string command = "xdotool search --pid " + std::to_string(pid) + " getwindowname %@ 2>/dev/null | head -1";
-    FILE* pipe = popen(command.c_str(), "r");
-    if (pipe) {
-        char buffer[256];
-        std::string result;
-        if (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-            result = buffer;
-            if (!result.empty() && result.back() == '\n') {
-                result.pop_back();
-            }
-        }
-        pclose(pipe);
-        if (!result.empty()) return result;
+    // Method 1: xdotool, first window of the process
+    const char* xdotool[] = {"xdotool", "search", "--pid", pidText.c_str(), "getwindowname", "%@", nullptr};
+    if (RunHelper(xdotool, output)) {
+        std::string title = output.substr(0, output.find('\n'));
+        if (!title.empty()) return title;
     }
     
-    // Method 2: wmctrl
-    command = "wmctrl -l -p | grep ' " + std::to_string(pid) + " ' | cut -d' ' -f4- 2>/dev/null | head -1";
-    pipe = popen(command.c_str(), "r");
-    if (pipe) {
-        char buffer[256];
-        std::string result;
-        if (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-            result = buffer;
-            if (!result.empty() && result.back() == '\n') {
-                result.pop_back();
-            }
+    // Method 2: wmctrl, "<window> <desktop> <pid> <host> <title>" per window
+    const char* wmctrl[] = {"wmctrl", "-l", "-p", nullptr};
+    output.clear();
+    if (!RunHelper(wmctrl, output)) return "";
+    size_t lineStart = 0;
+    while (lineStart < output.size()) {
+        size_t lineEnd = output.find('\n', lineStart);
+        if (lineEnd == std::string::npos) lineEnd = output.size();
+        
+        std::string_view line(output.data() + lineStart, lineEnd - lineStart);
+        std::string_view fields[4];
+        size_t position = 0;
+        for (auto& field : fields) {
+            size_t begin = line.find_first_not_of(' ', position);
+            if (begin == std::string_view::npos) begin = line.size();
+            position = std::min(line.find(' ', begin), line.size());
+            field = line.substr(begin, position - begin);
+        }
+        if (fields[2] == pidText) {
+            size_t titleStart = line.find_first_not_of(' ', position);
+            return titleStart == std::string_view::npos ? "" : std::string(line.substr(titleStart));
         }
-        pclose(pipe);
-        return result;
+        lineStart = lineEnd + 1;
     }
-    
     return "";
 }
 #endif
\ No newline at end of file
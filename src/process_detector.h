@@ -1,26 +1,38 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <string>
+#include "process_table.h"
 #include "../include/fl_studio_types.h"
 
 class CrossPlatformProcessDetector {
 public:
-    static std::vector<ProcessInfo> GetAllProcesses();
+    // Refills table with every running process (no window titles). Reusing
+    // one table across scans keeps steady-state scans allocation-free.
+    static void ScanProcesses(ProcessTable& table);
+    
+    // ProcessInfo views over a one-off scan
+    static std::vector<ProcessInfo> GetAllProcesses(bool includeWindowTitles = true);
     static std::vector<ProcessInfo> GetProcessesByName(const std::string& processName);
     static std::string GetWindowTitle(int pid);
+    // Real UID of the process owner, -1 if unknown or unsupported
+    static int GetProcessOwner(int pid);
+    // When the process started, in platform units; tells a PID apart from a
+    // later process reusing it. 0 if it has exited or is unknown.
+    static uint64_t GetProcessStartTime(int pid);
     static bool IsProcessRunning(const std::string& processName);
     static bool IsProcessRunning(int pid);
     
 private:
 #ifdef _WIN32
-    static std::vector<ProcessInfo> GetProcessesWindows();
+    static void ScanProcessesWindows(ProcessTable& table);
     static std::string GetWindowTitleWindows(int pid);
 #elif __APPLE__
-    static std::vector<ProcessInfo> GetProcessesMacOS();
+    static void ScanProcessesMacOS(ProcessTable& table);
     static std::string GetWindowTitleMacOS(int pid);
 #else // Linux
-    static std::vector<ProcessInfo> GetProcessesLinux();
+    static void ScanProcessesLinux(ProcessTable& table);
     static std::string GetWindowTitleLinux(int pid);
 #endif
 };
\ No newline at end of file
@@ -0,0 +1,30 @@
+#include "process_table.h"
+
+void ProcessTable::BeginScan() {
+    pids.clear();
+    nameIds.clear();
+    pathIds.clear();
+    flags.clear();
+
+    // Command lines of short-lived processes pile up; start over now and then
+    if (strings.GetBytes() > MAX_ARENA_BYTES) {
+        strings.Clear();
+        ++generation;
+    }
+}
+
+void ProcessTable::Add(int pid, std::string_view name, std::string_view executablePath, uint8_t rowFlags) {
+    pids.push_back(pid);
+    nameIds.push_back(strings.Intern(name));
+    pathIds.push_back(strings.Intern(executablePath));
+    flags.push_back(rowFlags);
+}
+
+ProcessInfo ProcessTable::ToProcessInfo(size_t row) const {
+    ProcessInfo info;
+    info.pid = pids[row];
+    info.name = GetName(row);
+    info.executablePath = GetPath(row);
+    info.isVisible = (flags[row] & Visible) != 0;
+    return info;
+}
\ No newline at end of file
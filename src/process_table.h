@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "string_arena.h"
+#include "../include/fl_studio_types.h"
+
+// One process scan stored column-wise. Names and paths are interned in an
+// arena that outlives the scan, so a steady-state rescan appends to vectors
+// that already have the capacity and finds every string already interned:
+// no per-process allocations. Matching code walks the contiguous id columns
+// and can cache verdicts per name id (see GetGeneration()).
+class ProcessTable {
+public:
+    using StringId = StringArena::Id;
+
+    enum Flags : uint8_t {
+        Visible = 1 << 0
+    };
+
+    // Starts a new scan: drops the rows, keeps capacity and interned strings.
+    // Once the arena has accumulated too many strings from processes that
+    // are gone it is cleared, which invalidates ids and bumps the generation.
+    void BeginScan();
+    void Add(int pid, std::string_view name, std::string_view executablePath, uint8_t flags = 0);
+
+    size_t Size() const { return pids.size(); }
+    bool Empty() const { return pids.empty(); }
+
+    const std::vector<int32_t>& GetPids() const { return pids; }
+    const std::vector<StringId>& GetNameIds() const { return nameIds; }
+    const std::vector<StringId>& GetPathIds() const { return pathIds; }
+    const std::vector<uint8_t>& GetFlags() const { return flags; }
+
+    std::string_view GetString(StringId id) const { return strings.Get(id); }
+    std::string_view GetName(size_t row) const { return strings.Get(nameIds[row]); }
+    std::string_view GetPath(size_t row) const { return strings.Get(pathIds[row]); }
+    size_t GetStringCount() const { return strings.GetCount(); }
+
+    // Changes whenever previously handed-out ids become meaningless
+    uint64_t GetGeneration() const { return generation; }
+
+    // Materializes one row through the legacy struct
+    ProcessInfo ToProcessInfo(size_t row) const;
+
+private:
+    static constexpr size_t MAX_ARENA_BYTES = 1024 * 1024;
+
+    std::vector<int32_t> pids;
+    std::vector<StringId> nameIds;
+    std::vector<StringId> pathIds;
+    std::vector<uint8_t> flags;
+    StringArena strings;
+    uint64_t generation = 0;
+};
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include "recording_watcher.h"
+#include "logger.h"
+#include "wine_prefix.h"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+#ifdef __linux__
+    #include <cerrno>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+    // A take is flushed several times a second; this much silence means the
+    // transport stopped even if FL Studio has not closed the file yet
+    constexpr std::chrono::milliseconds QUIET_PERIOD{1500};
+    constexpr size_t MAX_NEW_FILES = 256;
+
+    bool IsWaveFile(const char* name) {
+        size_t length = std::strlen(name);
+        if (length < 4) return false;
+        const char* extension = name + length - 4;
+        return extension[0] == '.' &&
+               std::tolower(static_cast<unsigned char>(extension[1])) == 'w' &&
+               std::tolower(static_cast<unsigned char>(extension[2])) == 'a' &&
+               std::tolower(static_cast<unsigned char>(extension[3])) == 'v';
+    }
+
+    std::filesystem::path RecordedBelow(const std::filesystem::path& documents) {
+        return documents / "Image-Line" / "FL Studio" / "Audio" / "Recorded";
+    }
+}
+
+RecordingWatcher::RecordingWatcher(EventLoop& loop, StateCallback callback)
+    : loop(loop)
+    , callback(std::move(callback)) {
+    quietTimer = loop.CreateTimer([this] {
+        growing.clear();
+        SetRecording(false);
+    });
+}
+
+RecordingWatcher::~RecordingWatcher() {
+    recording = false;  // No callback while the owner is being torn down
+    Stop();
+    loop.DestroyTimer(quietTimer);
+}
+
+void RecordingWatcher::Watch(const std::string& newDirectory) {
+    if (newDirectory == directory) return;
+    Stop();
+    directory = newDirectory;
+    if (directory.empty()) return;
+
+#ifdef __linux__
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd >= 0 &&
+        inotify_add_watch(inotifyFd, directory.c_str(), IN_CREATE | IN_MOVED_TO | IN_MODIFY | IN_CLOSE_WRITE) >= 0 &&
+        loop.WatchFd(inotifyFd, EventLoop::Readable, [this] { OnEvents(); })) {
+        LOG_INFO("Watching {} for recordings", directory);
+        return;
+    }
+    LOG_WARNING("Cannot watch {} for recordings: {}", directory, std::strerror(errno));
+    if (inotifyFd >= 0) {
+        close(inotifyFd);
+        inotifyFd = -1;
+    }
+#endif
+}
+
+void RecordingWatcher::Stop() {
+#ifdef __linux__
+    if (inotifyFd >= 0) {
+        loop.UnwatchFd(inotifyFd);
+        close(inotifyFd);
+        inotifyFd = -1;
+    }
+#endif
+    loop.DisarmTimer(quietTimer);
+    directory.clear();
+    newFiles.clear();
+    growing.clear();
+    SetRecording(false);
+}
+
+void RecordingWatcher::OnEvents() {
+#ifdef __linux__
+    alignas(inotify_event) char buffer[4096];
+    bool wrote = false;
+
+    while (true) {
+        ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) break;
+
+        for (char* cursor = buffer; cursor < buffer + length;) {
+            auto* event = reinterpret_cast<inotify_event*>(cursor);
+            cursor += sizeof(inotify_event) + event->len;
+            if (event->len == 0 || !IsWaveFile(event->name)) continue;
+
+            // Only takes started while we watch count; touching an old
+            // sample (normalizing, tagging) is not recording
+            if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                if (newFiles.size() >= MAX_NEW_FILES) newFiles.clear();
+                newFiles.insert(event->name);
+            } else if (event->mask & IN_MODIFY) {
+                if (newFiles.count(event->name)) {
+                    growing.insert(event->name);
+                    wrote = true;
+                }
+            } else if (event->mask & IN_CLOSE_WRITE) {
+                growing.erase(event->name);
+            }
+        }
+    }
+
+    if (wrote) {
+        SetRecording(true);
+        loop.ArmTimer(quietTimer, QUIET_PERIOD);
+    } else if (growing.empty() && recording) {
+        loop.DisarmTimer(quietTimer);
+        SetRecording(false);
+    }
+#endif
+}
+
+void RecordingWatcher::SetRecording(bool value) {
+    if (value == recording) return;
+    recording = value;
+    LOG_INFO("Recording {}", recording ? "started" : "stopped");
+    callback(recording);
+}
+
+std::string RecordingWatcher::FindRecordedFolder(int pid) {
+    std::error_code error;
+#ifdef _WIN32
+    (void)pid;
+    const char* profile = std::getenv("USERPROFILE");
+    if (!profile) return std::string();
+    auto folder = RecordedBelow(std::filesystem::path(profile) / "Documents");
+    return std::filesystem::is_directory(folder, error) ? folder.string() : std::string();
+#elif defined(__APPLE__)
+    (void)pid;
+    const char* home = std::getenv("HOME");
+    if (!home) return std::string();
+    auto folder = RecordedBelow(std::filesystem::path(home) / "Documents");
+    return std::filesystem::is_directory(folder, error) ? folder.string() : std::string();
+#else
+    // <prefix>/drive_c/users/<name>/Documents, usually a link to ~/Documents
+    std::string prefix = WinePrefixReader::FindPrefix(pid);
+    if (prefix.empty()) return std::string();
+
+    std::filesystem::directory_iterator users(std::filesystem::path(prefix) / "drive_c" / "users", error);
+    if (error) return std::string();
+    for (const auto& user : users) {
+        if (user.path().filename() == "Public") continue;
+        for (const char* documents : {"Documents", "My Documents"}) {
+            auto folder = RecordedBelow(user.path() / documents);
+            if (std::filesystem::is_directory(folder, error)) {
+                return folder.string();
+            }
+        }
+    }
+    return std::string();
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include "event_loop.h"
+
+// Detects FL Studio recording by watching the folder it records takes into.
+// A WAV file created after the watch started that keeps growing is a take in
+// progress; recording ends when it is closed or writes stop for a moment.
+// Linux only (inotify, no polling); elsewhere IsRecording() stays false.
+class RecordingWatcher {
+public:
+    using StateCallback = std::function<void(bool recording)>;
+
+    RecordingWatcher(EventLoop& loop, StateCallback callback);
+    ~RecordingWatcher();
+
+    RecordingWatcher(const RecordingWatcher&) = delete;
+    RecordingWatcher& operator=(const RecordingWatcher&) = delete;
+
+    // Switches to another folder; an empty path stops watching
+    void Watch(const std::string& directory);
+    void Stop();
+
+    bool IsRecording() const { return recording; }
+    const std::string& GetDirectory() const { return directory; }
+
+    // FL Studio's default "Audio/Recorded" folder for a running instance:
+    // inside its Wine prefix on Linux, under Documents elsewhere. Empty when
+    // it does not exist.
+    static std::string FindRecordedFolder(int pid);
+
+private:
+    void OnEvents();
+    void SetRecording(bool value);
+
+    EventLoop& loop;
+    StateCallback callback;
+    std::string directory;
+
+    EventLoop::TimerId quietTimer = -1;
+    int inotifyFd = -1;
+    std::unordered_set<std::string> newFiles;   // Created since the watch began
+    std::unordered_set<std::string> growing;    // Written and not yet closed
+    bool recording = false;
+};
\ No newline at end of file
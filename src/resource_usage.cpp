@@ -0,0 +1,102 @@
+#include "resource_usage.h"
+#include <cstdio>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <psapi.h>
+#elif defined(__APPLE__)
+    #include <mach/mach.h>
+    #include <sys/resource.h>
+    #include <time.h>
+#else
+    #include <sys/resource.h>
+    #include <time.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+#ifdef _WIN32
+    // FILETIME counts 100 ns ticks
+    std::chrono::nanoseconds FromFileTimes(const FILETIME& kernel, const FILETIME& user) {
+        ULARGE_INTEGER k;
+        ULARGE_INTEGER u;
+        k.LowPart = kernel.dwLowDateTime;
+        k.HighPart = kernel.dwHighDateTime;
+        u.LowPart = user.dwLowDateTime;
+        u.HighPart = user.dwHighDateTime;
+        return std::chrono::nanoseconds((k.QuadPart + u.QuadPart) * 100);
+    }
+#else
+    std::chrono::nanoseconds FromRusage(const struct rusage& usage) {
+        return std::chrono::seconds(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+               std::chrono::microseconds(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+    }
+#endif
+}
+
+size_t GetResidentSetBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.WorkingSetSize;
+    }
+    return 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS) {
+        return info.resident_size;
+    }
+    return 0;
+#else
+    // Second field of statm: resident pages
+    FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (!statm) return 0;
+
+    unsigned long size = 0;
+    unsigned long resident = 0;
+    int fields = std::fscanf(statm, "%lu %lu", &size, &resident);
+    std::fclose(statm);
+    if (fields != 2) return 0;
+    return static_cast<size_t>(resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+std::chrono::nanoseconds GetProcessCpuTime() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        return std::chrono::nanoseconds(0);
+    }
+    return FromFileTimes(kernel, user);
+#else
+    struct rusage self;
+    struct rusage children;
+    if (getrusage(RUSAGE_SELF, &self) != 0) return std::chrono::nanoseconds(0);
+    if (getrusage(RUSAGE_CHILDREN, &children) != 0) return FromRusage(self);
+    return FromRusage(self) + FromRusage(children);
+#endif
+}
+
+std::chrono::nanoseconds GetThreadCpuTime() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+        return std::chrono::nanoseconds(0);
+    }
+    return FromFileTimes(kernel, user);
+#else
+    struct timespec now;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) != 0) return std::chrono::nanoseconds(0);
+    return std::chrono::seconds(now.tv_sec) + std::chrono::nanoseconds(now.tv_nsec);
+#endif
+}
+
+const char* FormatBytes(size_t bytes, char* buffer, size_t size) {
+    if (bytes >= 1024 * 1024) {
+        std::snprintf(buffer, size, "%.1f MiB", bytes / (1024.0 * 1024.0));
+    } else {
+        std::snprintf(buffer, size, "%.1f KiB", bytes / 1024.0);
+    }
+    return buffer;
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+// Resident set size of the current process in bytes, 0 if unavailable
+size_t GetResidentSetBytes();
+
+// CPU time (user + system) used so far by the whole process, including
+// children it has reaped (e.g. helper commands), 0 if unavailable
+std::chrono::nanoseconds GetProcessCpuTime();
+// CPU time used so far by the calling thread, 0 if unavailable
+std::chrono::nanoseconds GetThreadCpuTime();
+
+// Formats bytes as e.g. "4.2 MiB" into buffer
+const char* FormatBytes(size_t bytes, char* buffer, size_t size);
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include "session_snapshot.h"
+#include "logger.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+    const char* HEADER = "# FL Studio Discord RPC session snapshot v1";
+
+    // One value per line: backslashes and newlines are escaped
+    std::string Escape(const std::string& value) {
+        std::string escaped;
+        escaped.reserve(value.size());
+        for (char c : value) {
+            if (c == '\\') escaped += "\\\\";
+            else if (c == '\n') escaped += "\\n";
+            else escaped += c;
+        }
+        return escaped;
+    }
+
+    std::string Unescape(const std::string& value) {
+        std::string plain;
+        plain.reserve(value.size());
+        for (size_t i = 0; i < value.size(); ++i) {
+            if (value[i] == '\\' && i + 1 < value.size()) {
+                ++i;
+                plain += value[i] == 'n' ? '\n' : value[i];
+            } else {
+                plain += value[i];
+            }
+        }
+        return plain;
+    }
+
+    // The snapshot names the open project and its path, so only its owner may read it
+    bool WriteOwnerOnly(const std::string& path, const std::string& contents) {
+#ifdef _WIN32
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        return file.is_open() && file.write(contents.data(), contents.size()).flush();
+#else
+        int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        if (fd < 0) return false;
+        // A leftover temporary keeps its old mode through O_CREAT
+        bool written = fchmod(fd, 0600) == 0;
+        for (size_t offset = 0; written && offset < contents.size();) {
+            ssize_t count = write(fd, contents.data() + offset, contents.size() - offset);
+            if (count < 0 && errno == EINTR) continue;
+            written = count > 0;
+            if (written) offset += static_cast<size_t>(count);
+        }
+        return close(fd) == 0 && written;
+#endif
+    }
+
+    // Replaces the destination atomically, so a crash never leaves half a snapshot
+    bool MoveIntoPlace(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+        // rename() refuses to overwrite an existing file on Windows
+        return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+    }
+}
+
+bool SessionSnapshot::Save(const std::string& path) const {
+    std::ostringstream file;
+    file << HEADER << "\n";
+    file << "pid=" << pid << "\n";
+    file << "processStart=" << processStart << "\n";
+    file << "sessionStart=" << static_cast<long long>(info.sessionStartTime) << "\n";
+    file << "unsaved=" << (info.hasUnsavedChanges ? 1 : 0) << "\n";
+    file << "project=" << Escape(info.projectName) << "\n";
+    file << "projectPath=" << Escape(info.projectPath) << "\n";
+    file << "version=" << Escape(info.version) << "\n";
+    file << "windowTitle=" << Escape(info.windowTitle) << "\n";
+    file << "executable=" << Escape(info.executablePath) << "\n";
+
+    std::string temporary = path + ".tmp";
+    if (!WriteOwnerOnly(temporary, file.str())) {
+        LOG_WARNING("Cannot write session snapshot {}", temporary);
+        std::remove(temporary.c_str());
+        return false;
+    }
+    if (!MoveIntoPlace(temporary, path)) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool SessionSnapshot::Load(const std::string& path, SessionSnapshot& snapshot) {
+    std::ifstream file(path);
+    std::string line;
+    if (!file.is_open() || !std::getline(file, line) || line != HEADER) {
+        return false;
+    }
+
+    snapshot = SessionSnapshot();
+    while (std::getline(file, line)) {
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) continue;
+        std::string key = line.substr(0, equals);
+        std::string value = line.substr(equals + 1);
+
+        if (key == "pid") snapshot.pid = std::atoi(value.c_str());
+        else if (key == "processStart") snapshot.processStart = std::strtoull(value.c_str(), nullptr, 10);
+        else if (key == "sessionStart") snapshot.info.sessionStartTime = static_cast<std::time_t>(std::atoll(value.c_str()));
+        else if (key == "unsaved") snapshot.info.hasUnsavedChanges = value == "1";
+        else if (key == "project") snapshot.info.projectName = Unescape(value);
+        else if (key == "projectPath") snapshot.info.projectPath = Unescape(value);
+        else if (key == "version") snapshot.info.version = Unescape(value);
+        else if (key == "windowTitle") snapshot.info.windowTitle = Unescape(value);
+        else if (key == "executable") snapshot.info.executablePath = Unescape(value);
+    }
+
+    snapshot.info.processId = snapshot.pid;
+    snapshot.info.isRunning = snapshot.pid > 0;
+    return true;
+}
\ No newline at end of file
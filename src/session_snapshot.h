@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "../include/fl_studio_types.h"
+
+// Last known FL Studio session, saved periodically and at shutdown so a
+// restarted daemon can show presence at once instead of after a cold scan.
+// The process start time guards against the PID having been reused.
+struct SessionSnapshot {
+    int pid = 0;
+    uint64_t processStart = 0;
+    FLStudioInfo info;
+
+    // Written to a temporary file and renamed over path
+    bool Save(const std::string& path) const;
+    static bool Load(const std::string& path, SessionSnapshot& snapshot);
+};
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "state_debouncer.h"
+#include <algorithm>
+
+template <typename T>
+bool StateDebouncer::Field<T>::Update(const T& raw, std::chrono::milliseconds hold, Clock::time_point now,
+                                      FieldStats& counters) {
+    bool isPending = deadline != Clock::time_point::max();
+    if (raw == shown) {
+        if (isPending) {
+            ++counters.suppressed;
+            deadline = Clock::time_point::max();
+        }
+        return false;
+    }
+
+    if (hold.count() <= 0) {
+        if (isPending) ++counters.suppressed;
+        shown = raw;
+        deadline = Clock::time_point::max();
+        ++counters.immediate;
+        return true;
+    }
+
+    // A different value restarts the hold
+    if (!isPending || !(raw == pending)) {
+        if (isPending) ++counters.suppressed;
+        pending = raw;
+        deadline = now + hold;
+    }
+    if (now < deadline) return false;
+    shown = pending;
+    deadline = Clock::time_point::max();
+    ++counters.delayed;
+    return true;
+}
+
+template <typename T>
+void StateDebouncer::Field<T>::Reset(const T& raw) {
+    shown = raw;
+    deadline = Clock::time_point::max();
+}
+
+void StateDebouncer::Apply(FLStudioInfo& info, Clock::time_point now) {
+    // A session starting or ending is never held back
+    if (!seen || info.isRunning != running || info.processId != processId) {
+        Reset(info);
+        return;
+    }
+    if (!info.isRunning) return;
+
+    // Project: dropping it is held, switching is not
+    bool projectChanged = project.Update(info.projectName, info.projectName.empty() ? holds.projectCleared :
+                                         std::chrono::milliseconds(0), now, stats.project);
+    bool projectHeld = info.projectName != project.shown;
+    if (projectHeld) {
+        info.projectName = project.shown;
+        info.projectPath = projectPath;
+    } else if (projectPath != info.projectPath) {
+        projectPath = info.projectPath;
+    }
+
+    // The marker belongs to the project in the title: a newly shown project
+    // brings its own, and while the project is held the title says nothing
+    if (projectChanged) {
+        unsaved.Reset(info.hasUnsavedChanges);
+    } else if (!projectHeld) {
+        unsaved.Update(info.hasUnsavedChanges, holds.unsaved, now, stats.unsaved);
+    }
+    info.hasUnsavedChanges = unsaved.shown;
+
+    playback.Update(GetPlayback(info), holds.playback, now, stats.playback);
+    info.isPlaying = playback.shown == Playback::Playing;
+    info.isPaused = playback.shown == Playback::Paused;
+
+    recording.Update(info.isRecording, info.isRecording ? std::chrono::milliseconds(0) : holds.recordingEnd, now,
+                     stats.recording);
+    info.isRecording = recording.shown;
+}
+
+StateDebouncer::Clock::time_point StateDebouncer::GetNextDeadline() const {
+    if (!running) return Clock::time_point::max();
+    return std::min({project.deadline, unsaved.deadline, playback.deadline, recording.deadline});
+}
+
+void StateDebouncer::Reset(const FLStudioInfo& info) {
+    seen = true;
+    running = info.isRunning;
+    processId = info.processId;
+    project.Reset(info.projectName);
+    projectPath = info.projectPath;
+    unsaved.Reset(info.hasUnsavedChanges);
+    playback.Reset(GetPlayback(info));
+    recording.Reset(info.isRecording);
+}
+
+StateDebouncer::Playback StateDebouncer::GetPlayback(const FLStudioInfo& info) {
+    if (info.isPlaying) return Playback::Playing;
+    if (info.isPaused) return Playback::Paused;
+    return Playback::Stopped;
+}
\ No newline at end of file
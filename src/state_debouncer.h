@@ -0,0 +1,79 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include "../include/fl_studio_types.h"
+
+// Filters transient detector states out before they reach presence. A
+// change of a noisy field is only shown once the new value has held for that
+// field's hold time; a value that flips back sooner is suppressed. Holds are
+// asymmetric where only one direction is noisy: a project that disappears
+// from the title (file dialogs) is held, a switch to another project is not;
+// recording shows at once and only its end is held. FL Studio starting or
+// exiting always passes straight through.
+class StateDebouncer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // 0 passes that field through unfiltered
+    struct Holds {
+        std::chrono::milliseconds projectCleared{2000};
+        std::chrono::milliseconds unsaved{1500};        // The '*' marker, either way
+        std::chrono::milliseconds playback{1500};       // Playing/paused/stopped, either way
+        std::chrono::milliseconds recordingEnd{3000};
+    };
+
+    struct FieldStats {
+        uint64_t suppressed = 0;    // Flipped back before the hold was up
+        uint64_t delayed = 0;       // Shown once the hold was up
+        uint64_t immediate = 0;     // Shown right away
+    };
+
+    struct Stats {
+        FieldStats project;
+        FieldStats unsaved;
+        FieldStats playback;
+        FieldStats recording;
+    };
+
+    void SetHolds(const Holds& newHolds) { holds = newHolds; }
+
+    // Rewrites info's noisy fields to the values presence should show
+    void Apply(FLStudioInfo& info, Clock::time_point now);
+
+    // When a held change is confirmed if it persists; time_point::max() when
+    // nothing is pending
+    Clock::time_point GetNextDeadline() const;
+
+    const Stats& GetStats() const { return stats; }
+
+private:
+    enum class Playback : uint8_t { Stopped, Playing, Paused };
+
+    template <typename T>
+    struct Field {
+        T shown{};
+        T pending{};
+        Clock::time_point deadline = Clock::time_point::max();  // Of pending, if any
+
+        // Returns true when the shown value changed
+        bool Update(const T& raw, std::chrono::milliseconds hold, Clock::time_point now, FieldStats& counters);
+        void Reset(const T& raw);
+    };
+
+    void Reset(const FLStudioInfo& info);
+
+    static Playback GetPlayback(const FLStudioInfo& info);
+
+    Holds holds;
+    Stats stats;
+    bool seen = false;
+    bool running = false;
+    int processId = 0;
+    Field<std::string> project;
+    std::string projectPath;        // Travels with the shown project
+    Field<bool> unsaved;
+    Field<Playback> playback;
+    Field<bool> recording;
+};
\ No newline at end of file
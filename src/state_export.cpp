@@ -0,0 +1,163 @@
+#include "state_export.h"
+#include "logger.h"
+#include "presence_renderer.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+    static_assert(sizeof(flrpc_state) == 1160, "flrpc_state layout changed; bump FLRPC_STATE_VERSION");
+    static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t) && std::atomic<uint64_t>::is_always_lock_free,
+                  "the seqlock needs lock-free 64-bit atomics in shared memory");
+    static_assert(static_cast<uint32_t>(FLStudioState::Paused) == FLRPC_ACTIVITY_PAUSED &&
+                  static_cast<uint32_t>(FLStudioState::Composing) == FLRPC_ACTIVITY_COMPOSING,
+                  "flrpc_activity mirrors FLStudioState");
+
+    // NUL-terminated, cut on a UTF-8 code point boundary
+    template <size_t N>
+    void CopyText(char (&out)[N], std::string_view text) {
+        size_t count = text.size();
+        if (count > N - 1) {
+            count = N - 1;
+            while (count > 0 && (static_cast<unsigned char>(text[count]) & 0xC0) == 0x80) {
+                --count;
+            }
+        }
+        std::memcpy(out, text.data(), count);
+        std::memset(out + count, 0, N - count);
+    }
+
+    std::atomic<uint64_t>& Sequence(flrpc_state* state) {
+        return *reinterpret_cast<std::atomic<uint64_t>*>(&state->sequence);
+    }
+}
+
+SharedStateExport::~SharedStateExport() {
+    Close();
+}
+
+bool SharedStateExport::Open(const std::string& segmentName) {
+    Close();
+    name = segmentName;
+    if (name.empty()) {
+        char defaultName[64];
+        if (flrpc_state_default_name(defaultName, sizeof(defaultName)) != 0) return false;
+        name = defaultName;
+    }
+
+    void* view = nullptr;
+#ifdef _WIN32
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, sizeof(flrpc_state), name.c_str());
+    if (!mapping) return false;
+    view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(flrpc_state));
+    if (!view) {
+        CloseHandle(mapping);
+        return false;
+    }
+    handle = mapping;
+#else
+    // Owner-only: the record can name the open project
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        LOG_WARNING("Cannot create shared state segment {}", name);
+        return false;
+    }
+    if (ftruncate(fd, sizeof(flrpc_state)) == 0) {
+        view = mmap(nullptr, sizeof(flrpc_state), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (view == nullptr || view == MAP_FAILED) {
+        LOG_WARNING("Cannot map shared state segment {}", name);
+        shm_unlink(name.c_str());
+        return false;
+    }
+#endif
+
+    // A segment left by a crashed daemon is reinitialized; readers only
+    // accept it once magic is written, after the rest of the header
+    shared = static_cast<flrpc_state*>(view);
+    uint64_t sequence = Sequence(shared).load(std::memory_order_relaxed);
+    shared->magic = 0;
+    shared->version = FLRPC_STATE_VERSION;
+    shared->size = sizeof(flrpc_state);
+#ifdef _WIN32
+    shared->writer_pid = static_cast<uint32_t>(GetCurrentProcessId());
+#else
+    shared->writer_pid = static_cast<uint32_t>(getpid());
+#endif
+    Sequence(shared).store(sequence + (sequence & 1), std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    shared->magic = FLRPC_STATE_MAGIC;
+
+    Publish(FLStudioInfo());
+    LOG_INFO("Publishing FL Studio state to shared memory {}", name);
+    return true;
+}
+
+void SharedStateExport::Close() {
+    if (!shared) return;
+    Publish(FLStudioInfo());
+
+#ifdef _WIN32
+    UnmapViewOfFile(shared);
+    CloseHandle(static_cast<HANDLE>(handle));
+    handle = nullptr;
+#else
+    munmap(shared, sizeof(flrpc_state));
+    shm_unlink(name.c_str());
+#endif
+    shared = nullptr;
+}
+
+void SharedStateExport::Publish(const FLStudioInfo& info) {
+    if (!shared) return;
+
+    // Staged locally so readers only ever wait for one memcpy
+    flrpc_state payload;
+    payload.updates = ++updates;
+    payload.updated_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    payload.session_start = info.isRunning ? static_cast<int64_t>(info.sessionStartTime) : 0;
+    payload.pid = info.isRunning ? info.processId : 0;
+    payload.bpm = info.bpm;
+    payload.pattern = info.currentPattern;
+    payload.flags = (info.isRunning ? FLRPC_STATE_RUNNING : 0) |
+                    (info.isPlaying ? FLRPC_STATE_PLAYING : 0) |
+                    (info.isRecording ? FLRPC_STATE_RECORDING : 0) |
+                    (info.isPaused ? FLRPC_STATE_PAUSED : 0) |
+                    (info.isIdle ? FLRPC_STATE_IDLE : 0) |
+                    (info.hasUnsavedChanges ? FLRPC_STATE_UNSAVED : 0);
+    payload.activity = static_cast<uint32_t>(GetFLStudioState(info));
+    payload.reserved = 0;
+    CopyText(payload.project, info.projectName);
+    CopyText(payload.fl_version, info.isRunning ? std::string_view(info.version) : std::string_view());
+    CopyText(payload.window_title, info.windowTitle);
+
+    BasicPresenceField<sizeof(payload.plugins) - 1> plugins;
+    for (const auto& plugin : info.plugins) {
+        if (!plugins.Empty()) plugins.Append(", ");
+        plugins.Append(plugin);
+    }
+    CopyText(payload.plugins, plugins.View());
+
+    // Seqlock write: odd, payload, even. The header before the sequence
+    // never changes after Open().
+    constexpr size_t PAYLOAD_OFFSET = offsetof(flrpc_state, updates);
+    auto& sequence = Sequence(shared);
+    uint64_t current = sequence.load(std::memory_order_relaxed);
+    sequence.store(current + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(reinterpret_cast<char*>(shared) + PAYLOAD_OFFSET, reinterpret_cast<const char*>(&payload) + PAYLOAD_OFFSET,
+                sizeof(flrpc_state) - PAYLOAD_OFFSET);
+    sequence.store(current + 2, std::memory_order_release);
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "../include/fl_studio_types.h"
+#include "../include/flrpc_state.h"
+
+// Writer side of flrpc_state.h: keeps the current FLStudioInfo in a
+// shared-memory record that local tools read lock-free. Publishing is a
+// seqlock-guarded copy of about a kilobyte, no system call.
+class SharedStateExport {
+public:
+    SharedStateExport() = default;
+    ~SharedStateExport();
+
+    SharedStateExport(const SharedStateExport&) = delete;
+    SharedStateExport& operator=(const SharedStateExport&) = delete;
+
+    // Creates (or takes over) the segment; an empty name means this user's default
+    bool Open(const std::string& name = std::string());
+    // Publishes "not running" and removes the segment
+    void Close();
+    bool IsOpen() const { return shared != nullptr; }
+
+    void Publish(const FLStudioInfo& info);
+
+private:
+    flrpc_state* shared = nullptr;
+    std::string name;
+    void* handle = nullptr;    // Windows mapping handle
+    uint64_t updates = 0;
+};
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "string_arena.h"
+#include <algorithm>
+
+StringArena::StringArena() {
+    Clear();
+}
+
+void StringArena::Clear() {
+    storage.clear();
+    entries.clear();
+    entries.push_back(Entry{0, 0, Hash(std::string_view())});
+    if (slots.empty()) {
+        slots.assign(1024, EMPTY);
+    } else {
+        std::fill(slots.begin(), slots.end(), EMPTY);
+    }
+}
+
+StringArena::Id StringArena::Intern(std::string_view text) {
+    if (text.empty()) return EMPTY;
+
+    uint64_t hash = Hash(text);
+    size_t mask = slots.size() - 1;
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        Id id = slots[slot];
+        if (id == EMPTY) {
+            id = static_cast<Id>(entries.size());
+            entries.push_back(Entry{static_cast<uint32_t>(storage.size()), static_cast<uint32_t>(text.size()), hash});
+            storage.append(text.data(), text.size());
+            slots[slot] = id;
+
+            // Keep the load factor under one half
+            if (entries.size() * 2 > slots.size()) {
+                Rehash(slots.size() * 2);
+            }
+            return id;
+        }
+        if (entries[id].hash == hash && Get(id) == text) {
+            return id;
+        }
+    }
+}
+
+void StringArena::Rehash(size_t slotCount) {
+    slots.assign(slotCount, EMPTY);
+    size_t mask = slotCount - 1;
+    for (Id id = 1; id < entries.size(); ++id) {
+        size_t slot = entries[id].hash & mask;
+        while (slots[slot] != EMPTY) {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = id;
+    }
+}
+
+// FNV-1a
+uint64_t StringArena::Hash(std::string_view text) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : text) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    return hash;
+}
\ No newline at end of file
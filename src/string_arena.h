@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Interns strings into one contiguous buffer and hands out dense 32-bit ids,
+// so repeated names and paths are stored (and compared) once. Id 0 is always
+// the empty string. Views returned by Get() stay valid until the next
+// Intern() or Clear(); ids stay valid until Clear().
+class StringArena {
+public:
+    using Id = uint32_t;
+    static constexpr Id EMPTY = 0;
+
+    StringArena();
+
+    Id Intern(std::string_view text);
+    std::string_view Get(Id id) const {
+        const Entry& entry = entries[id];
+        return std::string_view(storage.data() + entry.offset, entry.length);
+    }
+
+    size_t GetCount() const { return entries.size(); }
+    size_t GetBytes() const { return storage.size(); }
+
+    // Drops every string but keeps the allocated capacity
+    void Clear();
+
+private:
+    struct Entry {
+        uint32_t offset;
+        uint32_t length;
+        uint64_t hash;
+    };
+
+    static uint64_t Hash(std::string_view text);
+    void Rehash(size_t slotCount);
+
+    std::string storage;
+    std::vector<Entry> entries;   // Indexed by id
+    std::vector<Id> slots;        // Open addressing; EMPTY marks a free slot
+};
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "trace.h"
+#include "json_writer.h"
+#include "logger.h"
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> Tracer::enabled{false};
+
+namespace {
+    struct Span {
+        const char* name;
+        int64_t start;
+        int64_t end;
+    };
+
+    // Written only by its owning thread; 'written' publishes completed spans
+    struct ThreadBuffer {
+        uint32_t threadId = 0;
+        std::atomic<uint64_t> written{0};
+        Span spans[Tracer::EVENTS_PER_THREAD];
+    };
+
+    std::mutex g_registryMutex;
+    // Never shrinks, so a dump still sees the spans of threads that have exited
+    std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+    std::string g_outputPath;
+    int64_t g_origin = 0;
+
+    thread_local ThreadBuffer* t_buffer = nullptr;
+
+    ThreadBuffer* RegisterThread() {
+        auto buffer = std::make_unique<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        buffer->threadId = static_cast<uint32_t>(g_buffers.size() + 1);
+        g_buffers.push_back(std::move(buffer));
+        return g_buffers.back().get();
+    }
+}
+
+void Tracer::Start(const std::string& outputPath) {
+    {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        g_outputPath = outputPath;
+        g_origin = Now();
+    }
+    enabled.store(true);
+    LOG_INFO("Tracing enabled, spans will be written to {}", outputPath);
+}
+
+void Tracer::Record(const char* name, int64_t start, int64_t end) {
+    ThreadBuffer* buffer = t_buffer;
+    if (!buffer) {
+        buffer = t_buffer = RegisterThread();
+    }
+
+    uint64_t index = buffer->written.load(std::memory_order_relaxed);
+    buffer->spans[index % EVENTS_PER_THREAD] = Span{name, start, end};
+    buffer->written.store(index + 1, std::memory_order_release);
+}
+
+bool Tracer::Dump() {
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    if (g_outputPath.empty()) return false;
+
+    JsonWriter json(64 * 1024);
+    json.BeginObject();
+    json.Key("displayTimeUnit");
+    json.String("ms");
+    json.Key("traceEvents");
+    json.BeginArray();
+
+    json.BeginObject();
+    json.Key("name");
+    json.String("process_name");
+    json.Key("ph");
+    json.String("M");
+    json.Key("pid");
+    json.Int(1);
+    json.Key("args");
+    json.BeginObject();
+    json.Key("name");
+    json.String("FLStudioDiscordRPC");
+    json.EndObject();
+    json.EndObject();
+
+    size_t spanCount = 0;
+    for (const auto& buffer : g_buffers) {
+        uint64_t written = buffer->written.load(std::memory_order_acquire);
+        uint64_t first = written > EVENTS_PER_THREAD ? written - EVENTS_PER_THREAD : 0;
+        for (uint64_t i = first; i < written; ++i) {
+            const Span& span = buffer->spans[i % EVENTS_PER_THREAD];
+            // Complete events; timestamps are microseconds since Start()
+            json.BeginObject();
+            json.Key("name");
+            json.String(span.name);
+            json.Key("cat");
+            json.String("flrpc");
+            json.Key("ph");
+            json.String("X");
+            json.Key("ts");
+            json.Fixed(span.start - g_origin, 3);
+            json.Key("dur");
+            json.Fixed(span.end - span.start, 3);
+            json.Key("pid");
+            json.Int(1);
+            json.Key("tid");
+            json.UInt(buffer->threadId);
+            json.EndObject();
+            ++spanCount;
+        }
+    }
+
+    json.EndArray();
+    json.EndObject();
+
+    std::ofstream file(g_outputPath, std::ios::binary | std::ios::trunc);
+    if (!file || !file.write(json.View().data(), static_cast<std::streamsize>(json.View().size()))) {
+        LOG_ERROR("Failed to write trace to {}", g_outputPath);
+        return false;
+    }
+
+    LOG_INFO("Wrote {} trace spans to {}", spanCount, g_outputPath);
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,394 @@
+#include "websocket_sink.h"
+#include "logger.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#ifndef _WIN32
+    #include <arpa/inet.h>
+    #include <cerrno>
+    #include <csignal>
+    #include <fcntl.h>
+    #include <netinet/in.h>
+    #include <pthread.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+    constexpr const char* HANDSHAKE_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+    enum Opcode : uint8_t {
+        Text = 0x1,
+        Close = 0x8,
+        Ping = 0x9,
+        Pong = 0xA
+    };
+
+    // SHA-1 is only needed for the Sec-WebSocket-Accept header
+    void Sha1(const std::string& message, uint8_t digest[20]) {
+        uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+        auto rotate = [](uint32_t value, int bits) { return (value << bits) | (value >> (32 - bits)); };
+
+        std::string padded = message;
+        padded += static_cast<char>(0x80);
+        while (padded.size() % 64 != 56) padded += '\0';
+        uint64_t bitLength = static_cast<uint64_t>(message.size()) * 8;
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            padded += static_cast<char>((bitLength >> shift) & 0xFF);
+        }
+
+        for (size_t block = 0; block < padded.size(); block += 64) {
+            uint32_t w[80];
+            for (int i = 0; i < 16; ++i) {
+                const auto* bytes = reinterpret_cast<const uint8_t*>(padded.data() + block + i * 4);
+                w[i] = (uint32_t(bytes[0]) << 24) | (uint32_t(bytes[1]) << 16) | (uint32_t(bytes[2]) << 8) | bytes[3];
+            }
+            for (int i = 16; i < 80; ++i) {
+                w[i] = rotate(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+            }
+
+            uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+            for (int i = 0; i < 80; ++i) {
+                uint32_t f, k;
+                if (i < 20) { f = (b & c) | (~b & d); k = 0x5A827999; }
+                else if (i < 40) { f = b ^ c ^ d; k = 0x6ED9EBA1; }
+                else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+                else { f = b ^ c ^ d; k = 0xCA62C1D6; }
+                uint32_t next = rotate(a, 5) + f + e + k + w[i];
+                e = d;
+                d = c;
+                c = rotate(b, 30);
+                b = a;
+                a = next;
+            }
+            h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+        }
+
+        for (int i = 0; i < 5; ++i) {
+            digest[i * 4] = static_cast<uint8_t>(h[i] >> 24);
+            digest[i * 4 + 1] = static_cast<uint8_t>(h[i] >> 16);
+            digest[i * 4 + 2] = static_cast<uint8_t>(h[i] >> 8);
+            digest[i * 4 + 3] = static_cast<uint8_t>(h[i]);
+        }
+    }
+
+    std::string Base64(const uint8_t* data, size_t length) {
+        static const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string encoded;
+        for (size_t i = 0; i < length; i += 3) {
+            uint32_t chunk = uint32_t(data[i]) << 16;
+            if (i + 1 < length) chunk |= uint32_t(data[i + 1]) << 8;
+            if (i + 2 < length) chunk |= data[i + 2];
+            encoded += ALPHABET[(chunk >> 18) & 0x3F];
+            encoded += ALPHABET[(chunk >> 12) & 0x3F];
+            encoded += i + 1 < length ? ALPHABET[(chunk >> 6) & 0x3F] : '=';
+            encoded += i + 2 < length ? ALPHABET[chunk & 0x3F] : '=';
+        }
+        return encoded;
+    }
+
+    // Server frames are never masked or fragmented
+    std::string EncodeFrame(uint8_t opcode, const char* payload, size_t length) {
+        std::string frame;
+        frame.reserve(length + 10);
+        frame += static_cast<char>(0x80 | opcode);
+        if (length < 126) {
+            frame += static_cast<char>(length);
+        } else if (length < 65536) {
+            frame += static_cast<char>(126);
+            frame += static_cast<char>((length >> 8) & 0xFF);
+            frame += static_cast<char>(length & 0xFF);
+        } else {
+            frame += static_cast<char>(127);
+            for (int shift = 56; shift >= 0; shift -= 8) {
+                frame += static_cast<char>((static_cast<uint64_t>(length) >> shift) & 0xFF);
+            }
+        }
+        frame.append(payload, length);
+        return frame;
+    }
+
+    // Origins compare case-insensitively and without surrounding blanks or
+    // a trailing slash
+    std::string NormalizeOrigin(const std::string& origin) {
+        size_t first = origin.find_first_not_of(" \t");
+        if (first == std::string::npos) return std::string();
+        std::string normalized = origin.substr(first, origin.find_last_not_of(" \t") - first + 1);
+        std::transform(normalized.begin(), normalized.end(), normalized.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (!normalized.empty() && normalized.back() == '/') normalized.pop_back();
+        return normalized;
+    }
+}
+
+WebSocketSink::WebSocketSink(int port, const std::vector<std::string>& allowedOrigins)
+    : port(port) {
+    for (const auto& origin : allowedOrigins) {
+        std::string normalized = NormalizeOrigin(origin);
+        if (!normalized.empty()) this->allowedOrigins.push_back(std::move(normalized));
+    }
+}
+
+WebSocketSink::~WebSocketSink() {
+    loop.Stop();
+    if (thread.joinable()) {
+        thread.join();
+    }
+#ifndef _WIN32
+    for (const auto& entry : clients) {
+        close(entry.first);
+    }
+    if (listenFd >= 0) {
+        close(listenFd);
+    }
+#endif
+}
+
+bool WebSocketSink::Start() {
+#ifdef _WIN32
+    LOG_WARNING("The WebSocket presence server is not supported on this platform");
+    return false;
+#else
+    if (!loop.SupportsFdWatch()) {
+        LOG_WARNING("The WebSocket presence server is not supported on this platform");
+        return false;
+    }
+
+    listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) return false;
+    int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    // Loopback only: the presence is for widgets on this machine
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listenFd, 8) != 0 ||
+        !loop.WatchFd(listenFd, EventLoop::Readable, [this] { Accept(); })) {
+        LOG_WARNING("Cannot listen on 127.0.0.1:{} for WebSocket clients: {}", port, std::strerror(errno));
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    thread = std::thread([this] {
+        // Signals belong to the main event loop's signalfd, never to this thread
+        sigset_t all;
+        sigfillset(&all);
+        pthread_sigmask(SIG_BLOCK, &all, nullptr);
+        loop.Run();
+    });
+    LOG_INFO("WebSocket presence server listening on ws://127.0.0.1:{}", port);
+    return true;
+#endif
+}
+
+void WebSocketSink::Deliver(const PresenceEvent& event) {
+    std::string frame = EncodeFrame(Opcode::Text, event.json.data(), event.json.size());
+    loop.Post([this, frame = std::move(frame)] { Broadcast(frame); });
+}
+
+void WebSocketSink::Broadcast(const std::string& frame) {
+    latestFrame = frame;
+    std::vector<int> upgraded;
+    for (const auto& entry : clients) {
+        if (entry.second.upgraded) upgraded.push_back(entry.first);
+    }
+    for (int fd : upgraded) {
+        auto it = clients.find(fd);
+        if (it != clients.end()) Send(fd, it->second, frame);
+    }
+}
+
+void WebSocketSink::Accept() {
+#ifndef _WIN32
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        if (clients.size() >= MAX_CLIENTS) {
+            close(fd);
+            continue;
+        }
+        clients.emplace(fd, Client());
+        if (!loop.WatchFd(fd, EventLoop::Readable, [this, fd] { OnEvents(fd); })) {
+            clients.erase(fd);
+            close(fd);
+        }
+    }
+#endif
+}
+
+void WebSocketSink::OnEvents(int fd) {
+#ifndef _WIN32
+    auto it = clients.find(fd);
+    if (it == clients.end()) return;
+    Client& client = it->second;
+
+    // Readable also reports hang-ups; a writable socket may be waiting too
+    if (!client.outbox.empty()) {
+        Flush(fd, client);
+        if (clients.find(fd) == clients.end()) return;
+    }
+
+    char buffer[4096];
+    while (true) {
+        ssize_t count = recv(fd, buffer, sizeof(buffer), 0);
+        if (count > 0) {
+            client.inbox.append(buffer, static_cast<size_t>(count));
+            if (client.inbox.size() > MAX_INBOX_BYTES) {
+                Drop(fd);
+                return;
+            }
+            continue;
+        }
+        if (count == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            Drop(fd);
+            return;
+        }
+        if (errno != EINTR) break;
+    }
+
+    bool keep = client.upgraded ? ReadFrames(fd, client) : Handshake(fd, client);
+    if (!keep) Drop(fd);
+#endif
+}
+
+bool WebSocketSink::Handshake(int fd, Client& client) {
+    size_t end = client.inbox.find("\r\n\r\n");
+    if (end == std::string::npos) return true;  // Headers still arriving
+
+    std::string headers = client.inbox.substr(0, end + 2);
+    client.inbox.erase(0, end + 4);
+    std::string lower = headers;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    size_t keyStart = lower.find("\r\nsec-websocket-key:");
+    if (headers.compare(0, 4, "GET ") != 0 || keyStart == std::string::npos) {
+        Send(fd, client, "HTTP/1.1 400 Bad Request\r\nConnection: close\r\nContent-Length: 0\r\n\r\n");
+        return false;
+    }
+    if (!IsAllowedOrigin(lower)) {
+        Send(fd, client, "HTTP/1.1 403 Forbidden\r\nConnection: close\r\nContent-Length: 0\r\n\r\n");
+        return false;
+    }
+    keyStart += std::strlen("\r\nsec-websocket-key:");
+    size_t keyEnd = headers.find("\r\n", keyStart);
+    std::string key = headers.substr(keyStart, keyEnd - keyStart);
+    key.erase(0, key.find_first_not_of(" \t"));
+    key.erase(key.find_last_not_of(" \t") + 1);
+
+    uint8_t digest[20];
+    Sha1(key + HANDSHAKE_GUID, digest);
+    std::string response =
+        "HTTP/1.1 101 Switching Protocols\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Accept: " + Base64(digest, sizeof(digest)) + "\r\n\r\n";
+
+    client.upgraded = true;
+    Send(fd, client, response + latestFrame);
+    return clients.count(fd) > 0;
+}
+
+bool WebSocketSink::IsAllowedOrigin(const std::string& lowerHeaders) {
+    size_t start = lowerHeaders.find("\r\norigin:");
+    if (start == std::string::npos) return true;
+    start += std::strlen("\r\norigin:");
+    std::string origin = NormalizeOrigin(lowerHeaders.substr(start, lowerHeaders.find("\r\n", start) - start));
+
+    if (std::find(allowedOrigins.begin(), allowedOrigins.end(), origin) != allowedOrigins.end()) return true;
+    if (origin != refusedOrigin) {
+        LOG_WARNING("Refused a WebSocket client from origin {}; add it to webSocketOrigins to allow it", origin);
+        refusedOrigin = origin;
+    }
+    return false;
+}
+
+bool WebSocketSink::ReadFrames(int fd, Client& client) {
+    while (client.inbox.size() >= 2) {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(client.inbox.data());
+        uint8_t opcode = bytes[0] & 0x0F;
+        bool masked = (bytes[1] & 0x80) != 0;
+        uint64_t length = bytes[1] & 0x7F;
+        size_t header = 2;
+        if (length == 126) {
+            if (client.inbox.size() < 4) return true;
+            length = (uint64_t(bytes[2]) << 8) | bytes[3];
+            header = 4;
+        } else if (length == 127) {
+            if (client.inbox.size() < 10) return true;
+            length = 0;
+            for (int i = 0; i < 8; ++i) length = (length << 8) | bytes[2 + i];
+            header = 10;
+        }
+
+        // Clients must mask; anything too big for the inbox is not ours to read
+        if (!masked || length > MAX_INBOX_BYTES) return false;
+        if (client.inbox.size() < header + 4 + length) return true;
+
+        const uint8_t* mask = bytes + header;
+        std::string payload(client.inbox, header + 4, static_cast<size_t>(length));
+        for (size_t i = 0; i < payload.size(); ++i) {
+            payload[i] = static_cast<char>(payload[i] ^ mask[i % 4]);
+        }
+        client.inbox.erase(0, header + 4 + static_cast<size_t>(length));
+
+        if (opcode == Opcode::Close) {
+            Send(fd, client, EncodeFrame(Opcode::Close, payload.data(), std::min<size_t>(payload.size(), 2)));
+            return false;
+        }
+        if (opcode == Opcode::Ping) {
+            Send(fd, client, EncodeFrame(Opcode::Pong, payload.data(), payload.size()));
+            if (clients.find(fd) == clients.end()) return true;
+        }
+        // Text and binary frames from widgets are ignored
+    }
+    return true;
+}
+
+void WebSocketSink::Send(int fd, Client& client, const std::string& bytes) {
+    client.outbox += bytes;
+    Flush(fd, client);
+}
+
+void WebSocketSink::Flush(int fd, Client& client) {
+#ifndef _WIN32
+    while (!client.outbox.empty()) {
+        ssize_t sent = send(fd, client.outbox.data(), client.outbox.size(), MSG_NOSIGNAL);
+        if (sent > 0) {
+            client.outbox.erase(0, static_cast<size_t>(sent));
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        Drop(fd);
+        return;
+    }
+
+    // A client that stopped reading is cut loose instead of buffered for
+    if (client.outbox.size() > MAX_OUTBOX_BYTES) {
+        LOG_WARNING("WebSocket client stopped reading, disconnecting it");
+        Drop(fd);
+        return;
+    }
+    bool wantWrites = !client.outbox.empty();
+    if (wantWrites != client.watchingWrites) {
+        client.watchingWrites = wantWrites;
+        loop.ModifyFd(fd, wantWrites ? EventLoop::Readable | EventLoop::Writable : EventLoop::Readable);
+    }
+#endif
+}
+
+void WebSocketSink::Drop(int fd) {
+#ifndef _WIN32
+    if (clients.erase(fd) == 0) return;
+    loop.UnwatchFd(fd);
+    close(fd);
+#endif
+}
\ No newline at end of file
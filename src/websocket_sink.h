@@ -0,0 +1,64 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include "event_loop.h"
+#include "presence_bus.h"
+
+// Minimal RFC 6455 server on 127.0.0.1 for stream widgets (an OBS browser
+// source, say). Every connected client receives each presence event as a
+// JSON text frame, and the current one right after connecting. The server
+// runs its own event loop thread; a client that stops reading is dropped
+// once its unsent frames pass a small limit, so it cannot grow memory or
+// delay anyone else. Needs fd watches (Linux).
+//
+// Any web page the user visits may open a socket to 127.0.0.1, so browser
+// handshakes are only accepted from the allowed origins; clients that send
+// no Origin are not browsers. "null" is not implied: sandboxed frames and
+// data: URLs on any site send it too, so it must be listed explicitly.
+class WebSocketSink : public PresenceSink {
+public:
+    WebSocketSink(int port, const std::vector<std::string>& allowedOrigins);
+    ~WebSocketSink() override;
+
+    // Binds the port and starts the server thread
+    bool Start();
+
+    const char* GetName() const override { return "websocket"; }
+    void Deliver(const PresenceEvent& event) override;
+
+private:
+    struct Client {
+        std::string inbox;    // Request headers, then client frames
+        std::string outbox;   // Bytes the socket did not take yet
+        bool upgraded = false;
+        bool watchingWrites = false;
+    };
+
+    static constexpr size_t MAX_CLIENTS = 16;
+    static constexpr size_t MAX_INBOX_BYTES = 8 * 1024;
+    static constexpr size_t MAX_OUTBOX_BYTES = 64 * 1024;
+
+    void Accept();
+    void OnEvents(int fd);
+    bool Handshake(int fd, Client& client);
+    bool IsAllowedOrigin(const std::string& lowerHeaders);
+    bool ReadFrames(int fd, Client& client);
+    void Send(int fd, Client& client, const std::string& bytes);
+    void Flush(int fd, Client& client);
+    void Broadcast(const std::string& frame);
+    void Drop(int fd);
+
+    int port;
+    std::vector<std::string> allowedOrigins;    // Lowercase, no trailing '/'
+    int listenFd = -1;
+    EventLoop loop;
+    std::thread thread;
+
+    // Loop thread only
+    std::map<int, Client> clients;
+    std::string latestFrame;
+    std::string refusedOrigin;      // Last one warned about; a page may retry in a loop
+};
\ No newline at end of file
@@ -0,0 +1,304 @@
+#include "wine_prefix.h"
+#include "logger.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+
+#if !defined(_WIN32) && !defined(__APPLE__)
+    #include <fcntl.h>
+    #include <limits.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+    // user.reg doubles the backslashes of key names
+    constexpr std::string_view IMAGE_LINE_KEY = "[Software\\\\Image-Line\\\\";
+    constexpr size_t MAX_ENVIRON_BYTES = 256 * 1024;
+
+    bool IsProjectFile(std::string_view value) {
+        if (value.size() < 4) return false;
+        std::string_view extension = value.substr(value.size() - 4);
+        return extension[0] == '.' &&
+               std::tolower(static_cast<unsigned char>(extension[1])) == 'f' &&
+               std::tolower(static_cast<unsigned char>(extension[2])) == 'l' &&
+               std::tolower(static_cast<unsigned char>(extension[3])) == 'p';
+    }
+
+    void AppendUtf8(std::string& out, uint32_t codePoint) {
+        if (codePoint < 0x80) {
+            out += static_cast<char>(codePoint);
+        } else if (codePoint < 0x800) {
+            out += static_cast<char>(0xC0 | (codePoint >> 6));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else if (codePoint < 0x10000) {
+            out += static_cast<char>(0xE0 | (codePoint >> 12));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (codePoint >> 18));
+            out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    // Decodes a quoted user.reg string; pos starts after the opening quote
+    // and ends after the closing one. Non-ASCII text is written as \x<UTF-16>.
+    bool ReadQuoted(std::string_view text, size_t& pos, std::string& out) {
+        out.clear();
+        uint32_t highSurrogate = 0;
+        while (pos < text.size()) {
+            char c = text[pos++];
+            if (c == '"') return true;
+            if (c == '\n') return false;
+            if (c != '\\' || pos >= text.size()) {
+                out += c;
+                continue;
+            }
+
+            char escape = text[pos++];
+            if (escape != 'x') {
+                switch (escape) {
+                    case 'n': out += '\n'; break;
+                    case 'r': out += '\r'; break;
+                    case 't': out += '\t'; break;
+                    default: out += escape; break;  // \\ and \"
+                }
+                continue;
+            }
+
+            uint32_t unit = 0;
+            for (int digits = 0; digits < 4 && pos < text.size() && std::isxdigit(static_cast<unsigned char>(text[pos])); ++digits) {
+                char hex = static_cast<char>(std::tolower(static_cast<unsigned char>(text[pos++])));
+                unit = unit * 16 + static_cast<uint32_t>(hex <= '9' ? hex - '0' : hex - 'a' + 10);
+            }
+            if (unit >= 0xD800 && unit < 0xDC00) {
+                highSurrogate = unit;
+            } else if (unit >= 0xDC00 && unit < 0xE000 && highSurrogate) {
+                AppendUtf8(out, 0x10000 + ((highSurrogate - 0xD800) << 10) + (unit - 0xDC00));
+                highSurrogate = 0;
+            } else {
+                AppendUtf8(out, unit);
+            }
+        }
+        return false;
+    }
+
+    // "File12" -> 12; names without a number keep their file order at the end
+    uint64_t TrailingNumber(std::string_view name) {
+        size_t start = name.size();
+        while (start > 0 && std::isdigit(static_cast<unsigned char>(name[start - 1]))) --start;
+        if (start == name.size()) return UINT64_MAX;
+        uint64_t number = 0;
+        for (size_t i = start; i < name.size() && i < start + 18; ++i) {
+            number = number * 10 + static_cast<uint64_t>(name[i] - '0');
+        }
+        return number;
+    }
+}
+
+bool WinePrefixReader::Lookup(int pid, std::vector<std::string>& recentProjects) {
+#if defined(_WIN32) || defined(__APPLE__)
+    (void)pid;
+    (void)recentProjects;
+    return false;
+#else
+    // The environment of a process never changes, so it is read once per pid
+    auto known = pidPrefixes.find(pid);
+    if (known == pidPrefixes.end()) {
+        if (pidPrefixes.size() >= MAX_CACHED_PIDS) {
+            pidPrefixes.clear();
+        }
+        known = pidPrefixes.emplace(pid, FindPrefix(pid)).first;
+    }
+    if (known->second.empty()) return false;
+
+    Prefix& prefix = prefixes[known->second];
+    Refresh(known->second, prefix);
+    recentProjects = prefix.recentProjects;
+    return !recentProjects.empty();
+#endif
+}
+
+std::string WinePrefixReader::FindPrefix(int pid) {
+#if defined(_WIN32) || defined(__APPLE__)
+    (void)pid;
+    return std::string();
+#else
+    char path[64];
+    std::snprintf(path, sizeof(path), "/proc/%d/environ", pid);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return std::string();
+
+    std::string variables;
+    char buffer[4096];
+    ssize_t length;
+    while ((length = read(fd, buffer, sizeof(buffer))) > 0 && variables.size() < MAX_ENVIRON_BYTES) {
+        variables.append(buffer, static_cast<size_t>(length));
+    }
+    close(fd);
+
+    // NUL-separated NAME=value entries; Wine falls back to $HOME/.wine
+    std::string_view home;
+    std::string_view entries(variables);
+    while (!entries.empty()) {
+        size_t end = entries.find('\0');
+        std::string_view entry = entries.substr(0, end);
+        if (entry.compare(0, 11, "WINEPREFIX=") == 0 && entry.size() > 11) {
+            return std::string(entry.substr(11));
+        }
+        if (entry.compare(0, 5, "HOME=") == 0) {
+            home = entry.substr(5);
+        }
+        if (end == std::string_view::npos) break;
+        entries.remove_prefix(end + 1);
+    }
+    return home.empty() ? std::string() : std::string(home) + "/.wine";
+#endif
+}
+
+std::string WinePrefixReader::ToHostPath(const std::string& prefix, std::string_view windowsPath) {
+#if defined(_WIN32) || defined(__APPLE__)
+    (void)prefix;
+    (void)windowsPath;
+    return std::string();
+#else
+    if (windowsPath.size() < 3 || !std::isalpha(static_cast<unsigned char>(windowsPath[0])) ||
+        windowsPath[1] != ':' || (windowsPath[2] != '\\' && windowsPath[2] != '/')) {
+        return std::string();
+    }
+
+    // dosdevices/c: -> ../drive_c, dosdevices/z: -> / in a stock prefix
+    char drive = static_cast<char>(std::tolower(static_cast<unsigned char>(windowsPath[0])));
+    std::string device = prefix + "/dosdevices/" + drive + ":";
+    char target[PATH_MAX];
+    ssize_t length = readlink(device.c_str(), target, sizeof(target) - 1);
+
+    std::string base;
+    if (length > 0) {
+        base.assign(target, static_cast<size_t>(length));
+        if (base.compare(0, 3, "../") == 0) {
+            base = prefix + "/" + base.substr(3);
+        } else if (base[0] != '/') {
+            base = prefix + "/dosdevices/" + base;
+        }
+    } else if (drive == 'c') {
+        base = prefix + "/drive_c";
+    } else if (drive == 'z') {
+        base = "/";
+    } else {
+        return std::string();
+    }
+    while (!base.empty() && base.back() == '/') {
+        base.pop_back();
+    }
+
+    std::string path = base;
+    for (char c : windowsPath.substr(2)) {
+        path += c == '\\' ? '/' : c;
+    }
+    return path;
+#endif
+}
+
+void WinePrefixReader::Refresh(const std::string& path, Prefix& prefix) {
+#if !defined(_WIN32) && !defined(__APPLE__)
+    std::string registryPath = path + "/user.reg";
+    struct stat info;
+    if (stat(registryPath.c_str(), &info) != 0) {
+        prefix = Prefix();
+        return;
+    }
+
+    // Wine rewrites user.reg through a rename, so the inode changes too
+    int64_t modifiedNs = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+    if (prefix.inode == static_cast<uint64_t>(info.st_ino) && prefix.modifiedNs == modifiedNs &&
+        prefix.size == static_cast<int64_t>(info.st_size)) {
+        return;
+    }
+    prefix.inode = static_cast<uint64_t>(info.st_ino);
+    prefix.modifiedNs = modifiedNs;
+    prefix.size = static_cast<int64_t>(info.st_size);
+    prefix.recentProjects.clear();
+    if (info.st_size <= 0) return;
+
+    int fd = open(registryPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) return;
+
+    Parse(std::string_view(static_cast<const char*>(mapping), size), path, prefix.recentProjects);
+    munmap(mapping, size);
+    LOG_DEBUG("Read {} recent project(s) from {}", prefix.recentProjects.size(), registryPath);
+#else
+    (void)path;
+    (void)prefix;
+#endif
+}
+
+void WinePrefixReader::Parse(std::string_view registry, const std::string& prefixPath, std::vector<std::string>& recentProjects) {
+    struct Entry {
+        uint64_t order;
+        std::string path;
+    };
+    std::vector<Entry> best;
+    std::vector<Entry> section;
+    uint64_t bestTime = 0;
+    std::string name;
+    std::string value;
+
+    // Jump from one Image-Line key to the next; the rest of the (often
+    // multi-megabyte) hive is never looked at
+    size_t pos = registry.find(IMAGE_LINE_KEY);
+    while (pos != std::string_view::npos) {
+        if (pos > 0 && registry[pos - 1] != '\n') {
+            pos = registry.find(IMAGE_LINE_KEY, pos + 1);
+            continue;
+        }
+
+        // "[key] <modification time>"
+        size_t lineEnd = std::min(registry.find('\n', pos), registry.size());
+        size_t keyEnd = registry.find("] ", pos);
+        uint64_t time = 0;
+        if (keyEnd < lineEnd) {
+            for (size_t i = keyEnd + 2; i < lineEnd && std::isdigit(static_cast<unsigned char>(registry[i])); ++i) {
+                time = time * 10 + static_cast<uint64_t>(registry[i] - '0');
+            }
+        }
+
+        // "name"="string" values up to the next key
+        section.clear();
+        size_t line = lineEnd + 1;
+        while (line < registry.size() && registry[line] != '[') {
+            size_t next = std::min(registry.find('\n', line), registry.size());
+            size_t cursor = line + 1;
+            if (registry[line] == '"' && ReadQuoted(registry, cursor, name) &&
+                registry.compare(cursor, 2, "=\"") == 0) {
+                cursor += 2;
+                if (ReadQuoted(registry, cursor, value) && IsProjectFile(value)) {
+                    section.push_back({TrailingNumber(name), value});
+                }
+            }
+            line = next + 1;
+        }
+
+        // Several FL Studio versions may each keep a list; the newest wins
+        if (!section.empty() && (best.empty() || time >= bestTime)) {
+            best.swap(section);
+            bestTime = time;
+        }
+        pos = line < registry.size() ? registry.find(IMAGE_LINE_KEY, line) : std::string_view::npos;
+    }
+
+    std::stable_sort(best.begin(), best.end(), [](const Entry& a, const Entry& b) { return a.order < b.order; });
+    for (const auto& entry : best) {
+        std::string hostPath = ToHostPath(prefixPath, entry.path);
+        if (!hostPath.empty() && std::find(recentProjects.begin(), recentProjects.end(), hostPath) == recentProjects.end()) {
+            recentProjects.push_back(std::move(hostPath));
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Reads FL Studio's recent-project list out of a Wine prefix's user.reg, so
+// project paths do not depend on window titles. The prefix is taken from the
+// process's WINEPREFIX (default ~/.wine of that process's HOME), user.reg is
+// mmap()ed and only the Image-Line keys are parsed, and nothing is re-read
+// until the file changes. Linux only; elsewhere Lookup() finds nothing.
+class WinePrefixReader {
+public:
+    // Host paths, most recently used first
+    bool Lookup(int pid, std::vector<std::string>& recentProjects);
+
+    // WINEPREFIX of a running process, empty when unreadable
+    static std::string FindPrefix(int pid);
+    // "C:\users\me\song.flp" -> "<prefix>/drive_c/users/me/song.flp", following
+    // the prefix's dosdevices links. Empty for paths without a drive letter.
+    static std::string ToHostPath(const std::string& prefix, std::string_view windowsPath);
+
+private:
+    struct Prefix {
+        // user.reg identity at the last parse
+        uint64_t inode = 0;
+        int64_t modifiedNs = -1;
+        int64_t size = -1;
+        std::vector<std::string> recentProjects;
+    };
+
+    static constexpr size_t MAX_CACHED_PIDS = 64;
+
+    void Refresh(const std::string& path, Prefix& prefix);
+    static void Parse(std::string_view registry, const std::string& prefixPath, std::vector<std::string>& recentProjects);
+
+    std::unordered_map<int, std::string> pidPrefixes;
+    std::map<std::string, Prefix> prefixes;
+};
\ No newline at end of file